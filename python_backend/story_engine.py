@@ -4,8 +4,11 @@ Into the Dark - Story Engine
 Handles dialogue, choices, memory tracking, and save/load functionality.
 """
 
+import copy
 import json
+import mmap
 import os
+import struct
 import sys
 from typing import Dict, List, Tuple, Optional
 from dataclasses import dataclass, asdict
@@ -158,9 +161,11 @@ class StoryEngine:
         """Get the current scene"""
         return self.scenes[self.game_state.current_scene]
     
-    def make_choice(self, choice_index: int) -> Tuple[bool, str]:
+    def make_choice(self, choice_index: int, persist: bool = True) -> Tuple[bool, str]:
         """
         Make a choice and update game state
+        Set persist=False to apply the choice without writing the save file
+        (used for speculative evaluation).
         Returns: (success, message)
         """
         if choice_index < 0 or choice_index >= 4:
@@ -186,8 +191,9 @@ class StoryEngine:
                 self.game_state.current_scene += 1
         
         # Save game state
-        self.save_game()
-        
+        if persist:
+            self.save_game()
+
         return True, f"Choice made: {choice.text}"
     
     def get_memory_percentages(self) -> Dict[str, float]:
@@ -242,6 +248,234 @@ class StoryEngine:
         )
         return self.save_game()
 
+def _choice_target(engine: StoryEngine, scene_id: int, choice: Choice) -> int:
+    """Resolved target of a choice, mirroring make_choice: an explicit
+    next_scene wins, otherwise default progression to the next scene id,
+    capped at the final scene"""
+    if choice.next_scene:
+        return choice.next_scene
+    return scene_id + 1 if scene_id < len(engine.scenes) else scene_id
+
+def _scene_payload(engine: StoryEngine) -> Dict:
+    """Build the scene response payload expected by the C++ frontend"""
+    scene = engine.get_current_scene()
+    return {
+        "scene_id": scene.scene_id,
+        "background": scene.background,
+        "dialogue": scene.dialogue,
+        "audio_track": scene.audio_track,
+        "choices": [
+            {
+                "text": choice.text,
+                "memory_type": choice.memory_type.value,
+                "memory_value": choice.memory_value,
+                "next_scene": _choice_target(engine, scene.scene_id, choice)
+            }
+            for choice in scene.choices
+        ]
+    }
+
+def _memory_payload(engine: StoryEngine) -> Dict:
+    """Build the memory response payload expected by the C++ frontend"""
+    payload = dict(engine.get_memory_percentages())
+    payload["alignment"] = engine.get_memory_alignment()
+    return payload
+
+def _pack_scene_shm(engine: StoryEngine) -> bytes:
+    """
+    Pack the current scene in the fixed little-endian layout the C++ frontend
+    reads in place from the shared-memory ring:
+        int32 scene_id, uint32 background_len, uint32 dialogue_len,
+        uint32 audio_len, int32 choice_count,
+        background, dialogue, audio,
+        choice_count * (uint32 text_len, uint32 memory_type_len,
+                        int32 next_scene, text, type)
+    """
+    scene = engine.get_current_scene()
+    background = scene.background.encode("utf-8")
+    dialogue = scene.dialogue.encode("utf-8")
+    audio = (scene.audio_track or "").encode("utf-8")
+
+    out = struct.pack("<iIIIi", scene.scene_id, len(background), len(dialogue),
+                      len(audio), len(scene.choices))
+    out += background + dialogue + audio
+    for choice in scene.choices:
+        text = choice.text.encode("utf-8")
+        memory_type = choice.memory_type.value.encode("utf-8")
+        out += struct.pack("<IIi", len(text), len(memory_type),
+                           _choice_target(engine, scene.scene_id, choice))
+        out += text + memory_type
+    return out
+
+def _pack_memory_shm(engine: StoryEngine) -> bytes:
+    """
+    Pack the memory state for the shared-memory ring:
+        4 * double (kindness, obsession, truth, trust),
+        uint32 alignment_len, alignment
+    """
+    percentages = engine.get_memory_percentages()
+    alignment = engine.get_memory_alignment().encode("utf-8")
+    return struct.pack("<ddddI",
+                       percentages["kindness"], percentages["obsession"],
+                       percentages["truth"], percentages["trust"],
+                       len(alignment)) + alignment
+
+def serve():
+    """
+    Persistent worker mode for the C++ frontend.
+
+    Reads one JSON request per line from stdin and writes one JSON response
+    per line to stdout, so the interpreter and story data are loaded exactly
+    once per session instead of once per command.
+
+    Request format:  {"id": <int>, "cmd": <str>, ...args}
+    Response format: {"id": <int>, ...payload} or {"id": <int>, "error": <str>}
+
+    After a successful shm_init, scene and memory payloads are written into
+    the shared ring file in a fixed binary layout and the stdout response
+    carries only their (offset, length), so command latency is independent
+    of payload size.
+    """
+    engines = {0: StoryEngine()}
+    shm_map = None
+    shm_offset = 0
+
+    def get_engine(session: int) -> StoryEngine:
+        """Engine for a multiplexed session; extra sessions (attract mode)
+        load on demand and persist to their own save file"""
+        if session not in engines:
+            engines[session] = StoryEngine(
+                save_path=f"save/session_{session}.json")
+        return engines[session]
+
+    def shm_write(payload: bytes):
+        """Place a payload in the ring, wrapping at the end; None if it can't fit"""
+        nonlocal shm_offset
+        if shm_map is None or len(payload) > shm_map.size():
+            return None
+        if shm_offset + len(payload) > shm_map.size():
+            shm_offset = 0
+        offset = shm_offset
+        shm_map[offset:offset + len(payload)] = payload
+        shm_offset += len(payload)
+        return offset
+
+    def attach_scene(response, engine):
+        payload = _pack_scene_shm(engine)
+        offset = shm_write(payload)
+        if offset is None:
+            return _scene_payload(engine)
+        response["shm_scene"] = [offset, len(payload)]
+        return None
+
+    def attach_memory(response, engine):
+        payload = _pack_memory_shm(engine)
+        offset = shm_write(payload)
+        if offset is None:
+            return _memory_payload(engine)
+        response["shm_memory"] = [offset, len(payload)]
+        return None
+
+    for line in sys.stdin:
+        line = line.strip()
+        if not line:
+            continue
+
+        request_id = 0
+        try:
+            request = json.loads(line)
+            request_id = request.get("id", 0)
+            cmd = request.get("cmd", "")
+            response = {"id": request_id}
+            engine = get_engine(int(request.get("session", 0)))
+
+            if cmd == "get_scene":
+                inline = attach_scene(response, engine)
+                if inline is not None:
+                    response.update(inline)
+            elif cmd == "get_scene_graph":
+                # Ordered choice-target lists, scene 1 first; the frontend
+                # keeps index 0 as padding for direct subscripting
+                response["scenes"] = [
+                    [_choice_target(engine, scene_id, choice)
+                     for choice in engine.scenes[scene_id].choices]
+                    for scene_id in sorted(engine.scenes.keys())
+                ]
+                # Scenes whose payload depends on memory state; static scenes
+                # may be cached by the frontend forever
+                response["state_dependent"] = []
+            elif cmd == "get_memory":
+                inline = attach_memory(response, engine)
+                if inline is not None:
+                    response.update(inline)
+            elif cmd == "make_choice":
+                success, message = engine.make_choice(int(request.get("choice_index", -1)))
+                response["success"] = success
+                response["message"] = message
+            elif cmd == "advance":
+                # Batched transaction: apply the choice and return the
+                # resulting scene and memory in a single response
+                success, message = engine.make_choice(int(request.get("choice_index", -1)))
+                response["success"] = success
+                response["message"] = message
+                if success:
+                    scene_inline = attach_scene(response, engine)
+                    if scene_inline is not None:
+                        response["scene"] = scene_inline
+                    memory_inline = attach_memory(response, engine)
+                    if memory_inline is not None:
+                        response["memory"] = memory_inline
+            elif cmd == "peek_choice":
+                # Speculative evaluation: report the outcome a choice would
+                # have without committing it to the game state
+                snapshot = copy.deepcopy(engine.game_state)
+                success, message = engine.make_choice(
+                    int(request.get("choice_index", -1)), persist=False)
+                response["success"] = success
+                response["message"] = message
+                if success:
+                    scene_inline = attach_scene(response, engine)
+                    if scene_inline is not None:
+                        response["scene"] = scene_inline
+                    memory_inline = attach_memory(response, engine)
+                    if memory_inline is not None:
+                        response["memory"] = memory_inline
+                engine.game_state = snapshot
+            elif cmd == "shm_init":
+                try:
+                    shm_file = open(request["path"], "r+b")
+                    shm_map = mmap.mmap(shm_file.fileno(), 0)
+                    shm_offset = 0
+                    response["success"] = True
+                    response["size"] = shm_map.size()
+                except (OSError, KeyError, ValueError) as e:
+                    shm_map = None
+                    response["success"] = False
+                    response["message"] = str(e)
+            elif cmd == "restore_state":
+                scene_id = request.get("scene_id")
+                if scene_id in engine.scenes:
+                    engine.game_state.current_scene = scene_id
+                    for key, value in request.get("memory_values", {}).items():
+                        if key in engine.game_state.memory_values:
+                            engine.game_state.memory_values[key] = int(value)
+                    response["success"] = engine.save_game()
+                else:
+                    response["success"] = False
+                    response["error"] = f"Unknown scene: {scene_id}"
+            elif cmd == "reset_game":
+                response["success"] = engine.reset_game()
+            elif cmd == "quit":
+                print(json.dumps(response), flush=True)
+                break
+            else:
+                response["error"] = f"Unknown command: {cmd}"
+
+            print(json.dumps(response), flush=True)
+
+        except (json.JSONDecodeError, ValueError, KeyError) as e:
+            print(json.dumps({"id": request_id, "error": str(e)}), flush=True)
+
 def main():
     """Command-line interface for testing the story engine"""
     engine = StoryEngine()
@@ -280,4 +514,7 @@ def main():
     print("\nGame saved. Goodbye!")
 
 if __name__ == "__main__":
-    main()
+    if len(sys.argv) > 1 and sys.argv[1] == "serve":
+        serve()
+    else:
+        main()
@@ -0,0 +1,68 @@
+#include "asset_manifest.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QtConcurrent>
+
+AssetManifest::AssetManifest(QObject *parent)
+    : QObject(parent)
+    , m_totalImageBytes(0)
+    , m_scanned(false)
+{
+    connect(&m_watcher, &QFutureWatcher<AssetInfo>::finished,
+            this, &AssetManifest::onScanFinished);
+}
+
+AssetManifest::AssetInfo AssetManifest::probe(const QString &path)
+{
+    AssetInfo info;
+    info.path = path;
+    info.decodedBytes = 0;
+
+    if (path.endsWith(".jpg") || path.endsWith(".png")) {
+        // QImageReader reads only the header, so probing stays cheap even
+        // when the scan touches every cutscene
+        QImageReader reader(path);
+        info.dimensions = reader.size();
+        if (info.dimensions.isValid()) {
+            info.decodedBytes = qint64(info.dimensions.width())
+                * info.dimensions.height() * 4; // ARGB32 in the cache
+        }
+    } else {
+        info.decodedBytes = QFileInfo(path).size();
+    }
+
+    return info;
+}
+
+void AssetManifest::scan()
+{
+    QStringList paths;
+    const QDir cutscenes("assets/cutscenes");
+    for (const QString &name : cutscenes.entryList(
+             QStringList() << "*.jpg" << "*.png", QDir::Files)) {
+        paths.append(cutscenes.filePath(name));
+    }
+    const QDir audio("assets/audio");
+    for (const QString &name : audio.entryList(
+             QStringList() << "*.wav", QDir::Files)) {
+        paths.append(audio.filePath(name));
+    }
+
+    m_watcher.setFuture(QtConcurrent::mapped(paths, &AssetManifest::probe));
+}
+
+void AssetManifest::onScanFinished()
+{
+    m_entries.clear();
+    m_totalImageBytes = 0;
+    for (const AssetInfo &info : m_watcher.future().results()) {
+        m_entries.insert(info.path, info);
+        if (info.dimensions.isValid()) {
+            m_totalImageBytes += info.decodedBytes;
+        }
+    }
+    m_scanned = true;
+    emit scanFinished(m_entries.size(), m_totalImageBytes);
+}
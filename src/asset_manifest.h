@@ -0,0 +1,54 @@
+#ifndef ASSET_MANIFEST_H
+#define ASSET_MANIFEST_H
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+// Startup inventory of the shipped assets. scan() probes every file under
+// assets/cutscenes/ and assets/audio/ in parallel with QtConcurrent —
+// image headers only, no full decodes — and builds a manifest of existence,
+// dimensions and decoded byte sizes, so memory budgets are known up front
+// and missing art is discovered before a scene ever shows it.
+class AssetManifest : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct AssetInfo {
+        QString path;
+        QSize dimensions;    // images only
+        qint64 decodedBytes; // decoded size for images, payload size for audio
+    };
+
+    explicit AssetManifest(QObject *parent = nullptr);
+
+    void scan();
+    bool isScanned() const { return m_scanned; }
+
+    // Existence is manifest membership: the scan records only files found
+    bool exists(const QString &path) const { return m_entries.contains(path); }
+    AssetInfo info(const QString &path) const { return m_entries.value(path); }
+
+    // Total decoded size of all images, for sizing the pixmap cache
+    qint64 totalImageBytes() const { return m_totalImageBytes; }
+
+signals:
+    void scanFinished(int fileCount, qint64 totalImageBytes);
+
+private slots:
+    void onScanFinished();
+
+private:
+    static AssetInfo probe(const QString &path);
+
+    QFutureWatcher<AssetInfo> m_watcher;
+    QHash<QString, AssetInfo> m_entries;
+    qint64 m_totalImageBytes;
+    bool m_scanned;
+};
+
+#endif // ASSET_MANIFEST_H
@@ -0,0 +1,277 @@
+#include "audio_engine.h"
+
+#include <QAudioSink>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtEndian>
+
+namespace {
+// Half a second of 48kHz stereo 16-bit audio fits comfortably; the refill
+// timer runs well inside that window
+const qint64 kRingCapacity = 256 * 1024;
+const int kRefillIntervalMs = 100;
+const int kCrossfadeDurationMs = 1000;
+
+quint32 readU32(const QByteArray &bytes, int offset)
+{
+    return qFromLittleEndian<quint32>(
+        reinterpret_cast<const uchar *>(bytes.constData()) + offset);
+}
+
+quint16 readU16(const QByteArray &bytes, int offset)
+{
+    return qFromLittleEndian<quint16>(
+        reinterpret_cast<const uchar *>(bytes.constData()) + offset);
+}
+} // namespace
+
+AudioRingBuffer::AudioRingBuffer(qint64 capacity, QObject *parent)
+    : QIODevice(parent)
+    , m_head(0)
+    , m_filled(0)
+    , m_dataStart(0)
+    , m_dataLength(0)
+    , m_dataRemaining(0)
+{
+    m_ring.resize(capacity);
+    open(QIODevice::ReadOnly);
+}
+
+bool AudioRingBuffer::attachFile(const QString &path, QAudioFormat &format)
+{
+    detach();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Minimal RIFF/WAVE walk: find the fmt chunk for the stream parameters
+    // and the data chunk for the sample payload
+    QByteArray riff = m_file.read(12);
+    if (riff.size() != 12 || !riff.startsWith("RIFF") || riff.mid(8, 4) != "WAVE") {
+        m_file.close();
+        return false;
+    }
+
+    bool haveFormat = false;
+    while (!m_file.atEnd()) {
+        QByteArray chunkHeader = m_file.read(8);
+        if (chunkHeader.size() != 8) {
+            break;
+        }
+        QByteArray chunkId = chunkHeader.left(4);
+        quint32 chunkSize = readU32(chunkHeader, 4);
+
+        if (chunkId == "fmt ") {
+            QByteArray fmt = m_file.read(chunkSize);
+            if (fmt.size() < 16) {
+                break;
+            }
+            quint16 channels = readU16(fmt, 2);
+            quint32 sampleRate = readU32(fmt, 4);
+            quint16 bitsPerSample = readU16(fmt, 14);
+
+            format.setChannelCount(channels);
+            format.setSampleRate(static_cast<int>(sampleRate));
+            if (bitsPerSample == 8) {
+                format.setSampleFormat(QAudioFormat::UInt8);
+            } else if (bitsPerSample == 32) {
+                format.setSampleFormat(QAudioFormat::Int32);
+            } else {
+                format.setSampleFormat(QAudioFormat::Int16);
+            }
+            haveFormat = true;
+        } else if (chunkId == "data") {
+            m_dataStart = m_file.pos();
+            m_dataLength = chunkSize;
+            break;
+        } else {
+            m_file.seek(m_file.pos() + chunkSize);
+        }
+    }
+
+    if (!haveFormat || m_dataLength <= 0) {
+        m_file.close();
+        return false;
+    }
+
+    m_path = path;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_dataRemaining = m_dataLength;
+        m_head = 0;
+        m_filled = 0;
+    }
+    refill(); // prefill so playback starts without touching the disk
+    return true;
+}
+
+void AudioRingBuffer::refill()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    while (m_filled < m_ring.size()) {
+        if (m_dataRemaining <= 0) {
+            // Scene tracks loop: rewind to the start of the sample payload
+            m_file.seek(m_dataStart);
+            m_dataRemaining = m_dataLength;
+        }
+
+        qint64 writePos = (m_head + m_filled) % m_ring.size();
+        qint64 chunk = qMin(m_ring.size() - writePos, m_ring.size() - m_filled);
+        chunk = qMin(chunk, m_dataRemaining);
+
+        qint64 read = m_file.read(m_ring.data() + writePos, chunk);
+        if (read <= 0) {
+            break;
+        }
+        m_filled += read;
+        m_dataRemaining -= read;
+    }
+}
+
+void AudioRingBuffer::detach()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_path.clear();
+
+    QMutexLocker locker(&m_mutex);
+    m_head = 0;
+    m_filled = 0;
+    m_dataRemaining = 0;
+}
+
+qint64 AudioRingBuffer::bytesAvailable() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_filled + QIODevice::bytesAvailable();
+}
+
+qint64 AudioRingBuffer::readData(char *data, qint64 maxSize)
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 total = 0;
+    while (total < maxSize && m_filled > 0) {
+        qint64 chunk = qMin(maxSize - total, m_ring.size() - m_head);
+        chunk = qMin(chunk, m_filled);
+        memcpy(data + total, m_ring.constData() + m_head, chunk);
+        m_head = (m_head + chunk) % m_ring.size();
+        m_filled -= chunk;
+        total += chunk;
+    }
+    return total;
+}
+
+qint64 AudioRingBuffer::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+AudioEngine::AudioEngine(QObject *parent)
+    : QObject(parent)
+    , m_active(0)
+    , m_crossfade(new QVariantAnimation(this))
+    , m_refillTimer(new QTimer(this))
+{
+    for (Channel &channel : m_channels) {
+        channel.ring = new AudioRingBuffer(kRingCapacity, this);
+    }
+
+    m_crossfade->setDuration(kCrossfadeDurationMs);
+    m_crossfade->setEasingCurve(QEasingCurve::InOutQuad);
+    m_crossfade->setStartValue(0.0);
+    m_crossfade->setEndValue(1.0);
+
+    connect(m_crossfade, &QVariantAnimation::valueChanged,
+            this, [this](const QVariant &value) {
+        const qreal t = value.toReal();
+        if (m_channels[m_active].sink) {
+            m_channels[m_active].sink->setVolume(t);
+        }
+        if (m_channels[1 - m_active].sink) {
+            m_channels[1 - m_active].sink->setVolume(1.0 - t);
+        }
+    });
+    connect(m_crossfade, &QVariantAnimation::finished, this, [this]() {
+        stopChannel(m_channels[1 - m_active]);
+    });
+
+    m_refillTimer->setInterval(kRefillIntervalMs);
+    connect(m_refillTimer, &QTimer::timeout, this, &AudioEngine::refillRings);
+    m_refillTimer->start();
+}
+
+AudioEngine::~AudioEngine()
+{
+    for (Channel &channel : m_channels) {
+        stopChannel(channel);
+    }
+}
+
+QString AudioEngine::trackPath(const QString &trackName)
+{
+    // Engine data still names tracks audioN.mp3; the shipped assets are WAV
+    return QString("assets/audio/%1.wav")
+        .arg(QFileInfo(trackName).completeBaseName());
+}
+
+void AudioEngine::prefetch(const QString &path)
+{
+    Channel &standby = m_channels[1 - m_active];
+    if (standby.sink || standby.ring->path() == path || !QFile::exists(path)) {
+        return;
+    }
+    // Warm the standby ring now; setTrack() then starts playback without a
+    // disk read on the transition
+    standby.ring->attachFile(path, standby.format);
+}
+
+void AudioEngine::setTrack(const QString &path)
+{
+    if (path == m_currentPath) {
+        return;
+    }
+
+    Channel &incoming = m_channels[1 - m_active];
+    m_crossfade->stop();
+    stopChannel(incoming);
+
+    if (incoming.ring->path() != path || !incoming.ring->isAttached()) {
+        if (!incoming.ring->attachFile(path, incoming.format)) {
+            return;
+        }
+    }
+
+    incoming.sink = new QAudioSink(incoming.format, this);
+    incoming.sink->setVolume(0.0);
+    incoming.sink->start(incoming.ring);
+
+    m_active = 1 - m_active;
+    m_currentPath = path;
+    m_crossfade->start();
+}
+
+void AudioEngine::refillRings()
+{
+    for (Channel &channel : m_channels) {
+        if (channel.sink) {
+            channel.ring->refill();
+        }
+    }
+}
+
+void AudioEngine::stopChannel(Channel &channel)
+{
+    if (channel.sink) {
+        channel.sink->stop();
+        delete channel.sink;
+        channel.sink = nullptr;
+    }
+    channel.ring->detach();
+}
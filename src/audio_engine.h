@@ -0,0 +1,92 @@
+#ifndef AUDIO_ENGINE_H
+#define AUDIO_ENGINE_H
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariantAnimation>
+
+class QAudioSink;
+
+// Preallocated ring buffer feeding a QAudioSink in pull mode. attachFile
+// parses the WAV header, prefills the ring from disk, and the refill timer
+// tops it up in the background; the sink only ever reads decoded samples
+// that are already in memory, so playback never blocks on the file.
+// Some platform sink backends pull from an audio thread while refill runs
+// on the GUI thread, so the ring state is guarded by a mutex.
+class AudioRingBuffer : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit AudioRingBuffer(qint64 capacity, QObject *parent = nullptr);
+
+    bool attachFile(const QString &path, QAudioFormat &format);
+    void refill();
+    void detach();
+    bool isAttached() const { return m_file.isOpen(); }
+    QString path() const { return m_path; }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    // Guards the ring cursors and buffer against the sink's pull thread
+    mutable QMutex m_mutex;
+    QByteArray m_ring; // allocated once, reused across tracks
+    qint64 m_head;
+    qint64 m_filled;
+    QFile m_file;
+    QString m_path;
+    qint64 m_dataStart;
+    qint64 m_dataLength;
+    qint64 m_dataRemaining;
+};
+
+// Native audio path for scene tracks. Two ring-buffered sinks alternate as
+// active and standby: prefetch() warms the standby ring alongside the pixmap
+// preloader, and setTrack() crossfades from the playing track to the new one
+// on sceneChanged, so transitions have no subprocess round trip and no gap.
+class AudioEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AudioEngine(QObject *parent = nullptr);
+    ~AudioEngine();
+
+    // Resolves an engine track name like "audio1.mp3" to the shipped asset
+    static QString trackPath(const QString &trackName);
+
+    void prefetch(const QString &path);
+    void setTrack(const QString &path);
+
+private slots:
+    void refillRings();
+
+private:
+    struct Channel {
+        AudioRingBuffer *ring = nullptr;
+        QAudioSink *sink = nullptr;
+        QAudioFormat format;
+    };
+
+    void stopChannel(Channel &channel);
+
+    Channel m_channels[2];
+    int m_active; // index of the channel playing the current track
+    QString m_currentPath;
+    QVariantAnimation *m_crossfade;
+    QTimer *m_refillTimer;
+};
+
+#endif // AUDIO_ENGINE_H
@@ -0,0 +1,240 @@
+// Headless benchmark harness for the interaction loop.
+//
+// Drives the engine worker synchronously (no worker thread, so every slot
+// call completes before the timer stops) through scripted playthroughs, and
+// exercises CutsceneWidget::setCutscene against every shipped cutscene.
+// Results are printed as one JSON object per line so local runs can be
+// diffed between revisions. Run with QT_QPA_PLATFORM=offscreen on headless
+// machines; pass --python-engine to benchmark the subprocess backend.
+
+#include <QApplication>
+#include <QColor>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "cutscene_widget.h"
+#include "engine_interface.h"
+#include "pixmap_cache.h"
+
+// Allocation counter: every operator new in this process bumps the counter,
+// so (counter delta / iterations) is the allocation cost per interaction.
+static std::atomic<qint64> g_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+// Set when any benchmark exceeds its allocation budget or breaks an
+// invariant; the process exits non-zero so a regression fails the run, not
+// just a log line.
+bool g_budgetExceeded = false;
+
+double percentileUs(const QVector<qint64> &sortedNs, double fraction)
+{
+    if (sortedNs.isEmpty())
+        return 0.0;
+    int index = static_cast<int>(fraction * (sortedNs.size() - 1) + 0.5);
+    return sortedNs.at(index) / 1000.0;
+}
+
+void report(const QString &name, QVector<qint64> samplesNs, qint64 allocations,
+            double allocBudget)
+{
+    std::sort(samplesNs.begin(), samplesNs.end());
+
+    const double allocsPerOp = samplesNs.isEmpty()
+        ? 0.0
+        : static_cast<double>(allocations) / samplesNs.size();
+
+    QJsonObject row;
+    row["benchmark"] = name;
+    row["samples"] = samplesNs.size();
+    row["p50_us"] = percentileUs(samplesNs, 0.50);
+    row["p95_us"] = percentileUs(samplesNs, 0.95);
+    row["p99_us"] = percentileUs(samplesNs, 0.99);
+    row["allocs_per_op"] = allocsPerOp;
+    if (allocBudget > 0.0) {
+        row["alloc_budget"] = allocBudget;
+        if (allocsPerOp > allocBudget) {
+            g_budgetExceeded = true;
+            std::fprintf(stderr,
+                         "%s: %.1f allocations per op exceeds budget of %.0f\n",
+                         qPrintable(name), allocsPerOp, allocBudget);
+        }
+    }
+
+    std::printf("%s\n", QJsonDocument(row).toJson(QJsonDocument::Compact).constData());
+    std::fflush(stdout);
+}
+
+// Times `operation` `iterations` times and reports latency percentiles plus
+// the allocation delta per call. A non-zero `allocBudget` is asserted:
+// exceeding it marks the whole run failed.
+template <typename Operation>
+void runBench(const QString &name, int iterations, Operation &&operation,
+              double allocBudget = 0.0)
+{
+    QVector<qint64> samplesNs;
+    samplesNs.reserve(iterations);
+    qint64 allocations = 0;
+
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+        const qint64 allocsBefore = g_allocations.load(std::memory_order_relaxed);
+        timer.start();
+        operation(i);
+        samplesNs.append(timer.nsecsElapsed());
+        allocations += g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+    }
+
+    report(name, samplesNs, allocations, allocBudget);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    const QStringList args = app.arguments();
+    int iterations = 200;
+    const int iterationsIndex = args.indexOf("--iterations");
+    if (iterationsIndex >= 0 && iterationsIndex + 1 < args.size())
+        iterations = qMax(1, args.at(iterationsIndex + 1).toInt());
+
+    const StoryEngineWorker::Backend backend = args.contains("--python-engine")
+        ? StoryEngineWorker::PythonBackend
+        : StoryEngineWorker::NativeBackend;
+
+    // Allocation budgets hold only for the native engine; the subprocess
+    // backend allocates per round trip in the JSON transport by design.
+    const bool enforceBudgets = backend == StoryEngineWorker::NativeBackend
+        && !args.contains("--no-alloc-budget");
+
+    // The worker stays on the main thread here: direct slot calls make every
+    // request synchronous, so the timed region covers the full round trip.
+    StoryEngineWorker worker(backend, "save/bench_save.json");
+
+    SceneData lastScene;
+    QObject::connect(&worker, &StoryEngineWorker::sceneReady,
+                     [&lastScene](const SceneData &scene) { lastScene = scene; });
+
+    worker.applyReset();
+
+    runBench("engine.fetch_scene", iterations,
+             [&worker](int) { worker.fetchScene(); },
+             enforceBudgets ? 256 : 0);
+
+    runBench("engine.fetch_memory", iterations,
+             [&worker](int) { worker.fetchMemory(); },
+             enforceBudgets ? 64 : 0);
+
+    // Scripted playthrough: rotate through the four choice slots, restarting
+    // each time the story reaches its final scene so choices keep advancing.
+    runBench("engine.make_choice", iterations, [&](int i) {
+        if (lastScene.choices.isEmpty())
+            worker.applyReset();
+        worker.applyChoice(i % 4);
+    }, enforceBudgets ? 1024 : 0);
+
+    worker.applyReset();
+
+    // Cutscene decode-and-display over every shipped asset, cold then cached.
+    QDir cutsceneDir("assets/cutscenes");
+    QStringList assetNames = cutsceneDir.entryList(
+        QStringList() << "*.jpg" << "*.png", QDir::Files, QDir::Name);
+    QStringList assetPaths;
+    for (const QString &name : assetNames)
+        assetPaths.append(cutsceneDir.filePath(name));
+
+    if (!assetPaths.isEmpty()) {
+        CutsceneWidget widget;
+        widget.resize(800, 600);
+
+        runBench("cutscene.set_cold", assetPaths.size(), [&](int i) {
+            widget.setCutscene(assetPaths.at(i));
+        });
+
+        PixmapCache cache;
+        for (const QString &path : assetPaths)
+            cache.pixmap(path); // prewarm: synchronous decode fills the cache
+        widget.setPixmapCache(&cache);
+
+        runBench("cutscene.set_cached", iterations, [&](int i) {
+            widget.setCutscene(assetPaths.at(i % assetPaths.size()));
+        }, enforceBudgets ? 512 : 0);
+
+        // Residency manager under pressure: a budget well below the decoded
+        // working set forces evictions on every insert. Residency staying
+        // over budget afterwards means the scan found no victims — the
+        // manager is dead and the timings above measured nothing.
+        const int tightBudgetKb = 4 * 1024;
+        PixmapCache tight(nullptr, tightBudgetKb);
+        runBench("pixmap.evict_cold", assetPaths.size(), [&](int i) {
+            tight.pixmap(assetPaths.at(i));
+        });
+        if (tight.residentKb() > tightBudgetKb) {
+            std::fprintf(stderr,
+                         "pixmap.evict_cold: resident %lld KB never came down to "
+                         "the %d KB budget — no evictions occurred\n",
+                         tight.residentKb(), tightBudgetKb);
+            g_budgetExceeded = true;
+        }
+    }
+
+    // Atlas path: synthesized tiles small enough to shelf-pack, retrieved
+    // zero-copy through atlasRegion
+    {
+        const QString tileDir = QDir::temp().filePath("intothedark_bench_tiles");
+        QDir().mkpath(tileDir);
+        QStringList tilePaths;
+        for (int i = 0; i < 8; ++i) {
+            const QString path = QString("%1/tile%2.png").arg(tileDir).arg(i);
+            if (!QFile::exists(path)) {
+                QImage tile(256, 256, QImage::Format_ARGB32);
+                tile.fill(QColor(40 + i * 8, 40, 40));
+                tile.save(path);
+            }
+            tilePaths.append(path);
+        }
+
+        PixmapCache atlasCache;
+        for (const QString &path : tilePaths)
+            atlasCache.pixmap(path); // shelf-packs onto the shared page
+
+        runBench("pixmap.atlas_region", iterations, [&](int i) {
+            QPixmap page;
+            QRect rect;
+            atlasCache.atlasRegion(tilePaths.at(i % tilePaths.size()), page, rect);
+        }, enforceBudgets ? 8 : 0);
+    }
+
+    return g_budgetExceeded ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include "cutscene_widget.h"
+
+#include "trace_recorder.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QOpenGLWidget>
+#include <QPainter>
+
+CutsceneWidget::CutsceneWidget(QWidget *parent)
+    : QGraphicsView(parent)
+    , m_scene(new QGraphicsScene(this))
+    , m_currentItem(nullptr)
+    , m_previousItem(nullptr)
+    , m_crossfade(new QVariantAnimation(this))
+    , m_pixmapCache(nullptr)
+{
+    // GPU-backed surface: pixmap items upload as textures and opacity is a
+    // blend-state change, so the crossfade costs near-zero CPU per frame
+    setViewport(new QOpenGLWidget(this));
+    setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+
+    setScene(m_scene);
+    setRenderHint(QPainter::Antialiasing);
+    setRenderHint(QPainter::SmoothPixmapTransform);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+
+    m_previousItem = m_scene->addPixmap(QPixmap());
+    m_previousItem->setZValue(0);
+    m_currentItem = m_scene->addPixmap(QPixmap());
+    m_currentItem->setZValue(1);
+    m_currentItem->setOpacity(0.0);
+
+    m_crossfade->setDuration(1000);
+    m_crossfade->setEasingCurve(QEasingCurve::InOutQuad);
+    m_crossfade->setStartValue(0.0);
+    m_crossfade->setEndValue(1.0);
+
+    connect(m_crossfade, &QVariantAnimation::valueChanged,
+            this, [this](const QVariant &value) {
+        TraceSpan span("cutscene.crossfade_tick");
+        const qreal t = value.toReal();
+        m_currentItem->setOpacity(t);
+        m_previousItem->setOpacity(1.0 - t);
+    });
+    connect(m_crossfade, &QVariantAnimation::finished, this, [this]() {
+        // Release the outgoing texture once it is fully transparent
+        m_previousItem->setPixmap(QPixmap());
+    });
+}
+
+void CutsceneWidget::setPixmapCache(PixmapCache *cache)
+{
+    m_pixmapCache = cache;
+}
+
+void CutsceneWidget::prerenderPlaceholder(const QString &imagePath)
+{
+    placeholderFor(imagePath);
+}
+
+QPixmap CutsceneWidget::placeholderFor(const QString &imagePath)
+{
+    const auto cached = m_placeholders.constFind(imagePath);
+    if (cached != m_placeholders.constEnd())
+        return cached.value();
+
+    QPixmap pixmap(800, 600);
+    pixmap.fill(QColor(40, 40, 40));
+
+    QPainter painter(&pixmap);
+    painter.setPen(QPen(QColor(100, 100, 100), 2));
+    painter.setFont(QFont("Arial", 24));
+    painter.drawText(pixmap.rect(), Qt::AlignCenter,
+                    QString("Cutscene: %1\n(Placeholder)").arg(QFileInfo(imagePath).baseName()));
+
+    m_placeholders.insert(imagePath, pixmap);
+    return pixmap;
+}
+
+QString CutsceneWidget::resolveVariant(const QString &imagePath) const
+{
+    // Keep in sync with VARIANT_WIDTHS in tools/generate_cutscene_variants.py
+    static const int kVariantWidths[] = {640, 1280, 1920};
+
+    const int targetWidth = int(viewport()->width() * devicePixelRatioF());
+    const QFileInfo info(imagePath);
+    for (int width : kVariantWidths) {
+        if (width < targetWidth) {
+            continue;
+        }
+        const QString candidate = QString("%1/%2_%3.%4")
+            .arg(info.path(), info.completeBaseName())
+            .arg(width)
+            .arg(info.suffix());
+        // Variants only exist where the source was larger, so existence
+        // implies this one is both big enough and cheaper to decode
+        if (QFile::exists(candidate)) {
+            return candidate;
+        }
+    }
+    return imagePath;
+}
+
+void CutsceneWidget::setCutscene(const QString &imagePath)
+{
+    TraceSpan span("cutscene.set");
+
+    // Preloaded scenes resolve to a cache hit; only a cold path decodes here
+    const QString resolvedPath = resolveVariant(imagePath);
+    QPixmap pixmap = m_pixmapCache ? m_pixmapCache->pixmap(resolvedPath)
+                                   : QPixmap(resolvedPath);
+
+    if (pixmap.isNull())
+        pixmap = placeholderFor(imagePath);
+
+    // The outgoing scene keeps rendering underneath while the incoming one
+    // fades in on top: a true old-to-new crossfade, not a dip to black.
+    // Both items are persistent, so a switch is two setPixmap calls — no
+    // item churn and no BSP-index rebuild.
+    m_crossfade->stop();
+    m_previousItem->setPixmap(m_currentItem->pixmap());
+    m_previousItem->setOpacity(1.0);
+    m_currentItem->setPixmap(pixmap);
+    m_currentItem->setOpacity(0.0);
+
+    // Reframe only when the image dimensions actually change
+    if (pixmap.size() != m_displayedSize) {
+        m_displayedSize = pixmap.size();
+        m_scene->setSceneRect(pixmap.rect());
+        fitInView(m_scene->sceneRect(), Qt::KeepAspectRatio);
+    }
+
+    m_crossfade->setDirection(QAbstractAnimation::Forward);
+    m_crossfade->start();
+}
+
+void CutsceneWidget::fadeIn()
+{
+    m_previousItem->setPixmap(QPixmap());
+    m_crossfade->stop();
+    m_crossfade->setDirection(QAbstractAnimation::Forward);
+    m_crossfade->start();
+}
+
+void CutsceneWidget::fadeOut()
+{
+    m_crossfade->stop();
+    m_crossfade->setDirection(QAbstractAnimation::Backward);
+    m_crossfade->start();
+}
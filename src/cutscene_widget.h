@@ -0,0 +1,51 @@
+#ifndef CUTSCENE_WIDGET_H
+#define CUTSCENE_WIDGET_H
+
+#include <QGraphicsPixmapItem>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QHash>
+#include <QString>
+#include <QVariantAnimation>
+
+#include "pixmap_cache.h"
+
+// Cutscene view rendered through a QOpenGLWidget viewport. The two pixmap
+// items are composited as textured quads on the GPU, so transitions are a
+// per-frame opacity blend in the compositor rather than a software re-render
+// of the whole view through QGraphicsOpacityEffect.
+class CutsceneWidget : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    explicit CutsceneWidget(QWidget *parent = nullptr);
+    void setPixmapCache(PixmapCache *cache);
+    void setCutscene(const QString &imagePath);
+    // Maps a cutscene path to the pre-generated variant closest to the
+    // current viewport, falling back to the original when none exists
+    QString resolveVariant(const QString &imagePath) const;
+    // Renders the missing-asset placeholder ahead of time so first display
+    // never paints one on the GUI thread mid-transition
+    void prerenderPlaceholder(const QString &imagePath);
+    void fadeIn();
+    void fadeOut();
+
+private:
+    QPixmap placeholderFor(const QString &imagePath);
+
+    QGraphicsScene *m_scene;
+    // Incoming scene on top, outgoing scene underneath; the crossfade blends
+    // their opacities in opposite directions
+    QGraphicsPixmapItem *m_currentItem;
+    QGraphicsPixmapItem *m_previousItem;
+    QVariantAnimation *m_crossfade;
+    PixmapCache *m_pixmapCache;
+    // Placeholders render once per missing asset and are reused afterwards
+    QHash<QString, QPixmap> m_placeholders;
+    // Size of the last displayed pixmap; the scene rect and view transform
+    // are only recomputed when it changes
+    QSize m_displayedSize;
+};
+
+#endif // CUTSCENE_WIDGET_H
@@ -0,0 +1,146 @@
+#include "dialogue_widget.h"
+
+#include <QPainter>
+
+namespace {
+const int kPadding = 10;
+const int kRevealIntervalMs = 16;   // one frame at 60fps
+const int kCharsPerTick = 2;        // ~120 characters per second
+} // namespace
+
+DialogueWidget::DialogueWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_current(nullptr)
+    , m_visibleChars(0)
+    , m_revealTimer(new QTimer(this))
+{
+    m_dialogueFont = font();
+    m_dialogueFont.setPointSize(11);
+
+    m_revealTimer->setInterval(kRevealIntervalMs);
+    connect(m_revealTimer, &QTimer::timeout, this, &DialogueWidget::advanceReveal);
+}
+
+DialogueWidget::~DialogueWidget()
+{
+    qDeleteAll(m_layouts);
+}
+
+DialogueWidget::CachedLayout *DialogueWidget::layoutFor(int sceneId, const QString &text)
+{
+    CachedLayout *cached = m_layouts.value(sceneId, nullptr);
+    if (cached && cached->text == text) {
+        return cached;
+    }
+
+    delete cached;
+    cached = new CachedLayout;
+    cached->text = text;
+
+    // QTextLayout only breaks on line separators, not newlines
+    QString layoutText = text;
+    layoutText.replace(QLatin1Char('\n'), QChar::LineSeparator);
+    cached->layout.setText(layoutText);
+    cached->layout.setFont(m_dialogueFont);
+
+    m_layouts.insert(sceneId, cached);
+    return cached;
+}
+
+void DialogueWidget::ensureLaidOut(CachedLayout *cached)
+{
+    const int layoutWidth = width() - 2 * kPadding;
+    if (cached->layoutWidth == layoutWidth) {
+        return; // cache hit: the expensive line-breaking pass is skipped
+    }
+
+    cached->layout.beginLayout();
+    qreal y = 0;
+    forever {
+        QTextLine line = cached->layout.createLine();
+        if (!line.isValid()) {
+            break;
+        }
+        line.setLineWidth(layoutWidth);
+        line.setPosition(QPointF(0, y));
+        y += line.height();
+    }
+    cached->layout.endLayout();
+    cached->layoutWidth = layoutWidth;
+}
+
+void DialogueWidget::setDialogue(int sceneId, const QString &text)
+{
+    m_current = layoutFor(sceneId, text);
+    m_visibleChars = 0;
+    m_revealTimer->start();
+    update();
+}
+
+void DialogueWidget::revealAll()
+{
+    if (m_current) {
+        m_visibleChars = m_current->layout.text().size();
+    }
+    m_revealTimer->stop();
+    update();
+}
+
+void DialogueWidget::advanceReveal()
+{
+    if (!m_current) {
+        m_revealTimer->stop();
+        return;
+    }
+
+    m_visibleChars += kCharsPerTick;
+    if (m_visibleChars >= m_current->layout.text().size()) {
+        m_visibleChars = m_current->layout.text().size();
+        m_revealTimer->stop();
+    }
+    update();
+}
+
+void DialogueWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    painter.setPen(QPen(QColor(0x66, 0x66, 0x66), 1));
+    painter.setBrush(QColor(0, 0, 0, 150));
+    painter.drawRoundedRect(rect().adjusted(0, 0, -1, -1), 5, 5);
+
+    if (!m_current) {
+        return;
+    }
+    ensureLaidOut(m_current);
+
+    painter.setPen(QColor(0xE0, 0xE0, 0xE0));
+    const QPointF origin(kPadding, kPadding);
+
+    for (int i = 0; i < m_current->layout.lineCount(); ++i) {
+        QTextLine line = m_current->layout.lineAt(i);
+        if (line.textStart() + line.textLength() <= m_visibleChars) {
+            line.draw(&painter, origin);
+        } else if (line.textStart() < m_visibleChars) {
+            // Boundary line: clip to the x position of the reveal cursor
+            const qreal clipX = line.cursorToX(m_visibleChars);
+            painter.save();
+            painter.setClipRect(QRectF(origin.x() + line.rect().left(),
+                                       origin.y() + line.rect().top(),
+                                       clipX - line.rect().left(),
+                                       line.rect().height()));
+            line.draw(&painter, origin);
+            painter.restore();
+            break;
+        } else {
+            break;
+        }
+    }
+}
+
+void DialogueWidget::mousePressEvent(QMouseEvent *)
+{
+    // Clicking skips to the full text, like every visual novel ever
+    revealAll();
+}
@@ -0,0 +1,51 @@
+#ifndef DIALOGUE_WIDGET_H
+#define DIALOGUE_WIDGET_H
+
+#include <QFont>
+#include <QHash>
+#include <QString>
+#include <QTextLayout>
+#include <QTimer>
+#include <QWidget>
+
+// Dialogue panel with a typewriter reveal. The scene text is laid out once
+// into a QTextLayout and revealed by advancing a character counter at paint
+// time — full lines draw directly and the boundary line draws through a clip
+// rect — so the reveal never relayouts. Layouts are cached per scene, so
+// re-showing dialogue costs zero layout work.
+class DialogueWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DialogueWidget(QWidget *parent = nullptr);
+    ~DialogueWidget();
+
+    void setDialogue(int sceneId, const QString &text);
+    void revealAll();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private slots:
+    void advanceReveal();
+
+private:
+    struct CachedLayout {
+        QString text;
+        QTextLayout layout;
+        int layoutWidth = -1; // width the layout was computed for
+    };
+
+    CachedLayout *layoutFor(int sceneId, const QString &text);
+    void ensureLaidOut(CachedLayout *cached);
+
+    QHash<int, CachedLayout *> m_layouts;
+    CachedLayout *m_current;
+    int m_visibleChars;
+    QTimer *m_revealTimer;
+    QFont m_dialogueFont;
+};
+
+#endif // DIALOGUE_WIDGET_H
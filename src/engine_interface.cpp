@@ -0,0 +1,1289 @@
+#include "engine_interface.h"
+
+#include "scene_bindings.h"
+#include "trace_recorder.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace {
+
+const qint64 kShmSize = 1 << 20; // payload ring size
+
+// Reads a length-prefixed UTF-8 string out of a mapped payload, advancing the
+// cursor; returns empty on a truncated record rather than reading past the end
+QString takeUtf8(const uchar *&p, const uchar *end, quint32 length)
+{
+    if (p + length > end) {
+        return QString();
+    }
+    QString text = QString::fromUtf8(reinterpret_cast<const char *>(p), int(length));
+    p += length;
+    return text;
+}
+
+} // namespace
+
+StoryEngineWorker::StoryEngineWorker(Backend backend, const QString &savePath)
+    : m_backend(backend)
+    , m_savePath(savePath)
+    , m_nativeEngine(nullptr)
+    , m_pythonProcess(nullptr)
+    , m_nextRequestId(0)
+    , m_standbyProcess(nullptr)
+    , m_shuttingDown(false)
+    , m_requestDepth(0)
+    , m_hasJournalState(false)
+    , m_shmFile(nullptr)
+    , m_shmData(nullptr)
+    , m_shmSize(0)
+    , m_shmActive(false)
+    , m_backgroundTimer(nullptr)
+{
+}
+
+StoryEngineWorker::~StoryEngineWorker()
+{
+    m_shuttingDown = true;
+
+    // Clean shutdown snapshots journaled progress so the next launch reads
+    // it from the snapshot instead of replaying the journal
+    if (m_nativeEngine) {
+        m_nativeEngine->compactJournal();
+    }
+    for (auto it = m_sessionEngines.constBegin(); it != m_sessionEngines.constEnd(); ++it) {
+        it.value()->compactJournal();
+    }
+
+    delete m_nativeEngine;
+    qDeleteAll(m_sessionEngines);
+
+    if (m_standbyProcess && m_standbyProcess->state() == QProcess::Running) {
+        m_standbyProcess->kill();
+        m_standbyProcess->waitForFinished(500);
+    }
+
+    if (m_pythonProcess && m_pythonProcess->state() == QProcess::Running) {
+        // Ask the worker to exit cleanly before falling back to kill
+        m_pythonProcess->write("{\"id\": 0, \"cmd\": \"quit\"}\n");
+        m_pythonProcess->closeWriteChannel();
+        if (!m_pythonProcess->waitForFinished(1000)) {
+            m_pythonProcess->kill();
+            m_pythonProcess->waitForFinished(1000);
+        }
+    }
+
+    if (m_shmFile) {
+        m_shmFile->remove();
+    }
+}
+
+StoryEngine *StoryEngineWorker::ensureNativeEngine()
+{
+    if (!m_nativeEngine) {
+        m_nativeEngine = new StoryEngine(m_savePath);
+    }
+    return m_nativeEngine;
+}
+
+QString StoryEngineWorker::getPythonScriptPath()
+{
+    QDir appDir(QCoreApplication::applicationDirPath());
+    QString scriptPath = appDir.absoluteFilePath("../python_backend/story_engine.py");
+
+    if (!QFile::exists(scriptPath)) {
+        // Try relative to current working directory
+        scriptPath = "python_backend/story_engine.py";
+    }
+
+    return scriptPath;
+}
+
+bool StoryEngineWorker::ensureEngineStarted()
+{
+    if (m_pythonProcess && m_pythonProcess->state() == QProcess::Running) {
+        return true;
+    }
+
+    // A dead primary with a warm standby waiting is the fast path: promote
+    // it instead of paying a cold interpreter spawn
+    if (m_pythonProcess && promoteStandby()) {
+        return true;
+    }
+
+    if (!m_pythonProcess) {
+        m_pythonProcess = new QProcess(this);
+        m_pythonProcess->setProcessChannelMode(QProcess::SeparateChannels);
+        m_pythonScriptPath = getPythonScriptPath();
+        connect(m_pythonProcess,
+                QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                this, &StoryEngineWorker::onPrimaryDied);
+    }
+
+    // Launch the engine once as a long-lived worker; every command afterwards
+    // is a single line on stdin instead of a fresh interpreter spawn.
+    m_readBuffer.clear();
+    m_pythonProcess->start("python3", QStringList() << m_pythonScriptPath << "serve");
+
+    if (!m_pythonProcess->waitForStarted(5000)) {
+        emit errorOccurred("Failed to start story engine worker");
+        return false;
+    }
+
+    setupSharedMemory();
+    startStandby();
+    return true;
+}
+
+void StoryEngineWorker::startStandby()
+{
+    if (m_backend != PythonBackend || m_shuttingDown) {
+        return;
+    }
+    if (m_standbyProcess && m_standbyProcess->state() == QProcess::Running) {
+        return;
+    }
+
+    // Spawned without waiting: the interpreter imports the engine in the
+    // background and sits idle until promoted
+    delete m_standbyProcess;
+    m_standbyProcess = new QProcess(this);
+    m_standbyProcess->setProcessChannelMode(QProcess::SeparateChannels);
+    m_standbyProcess->start("python3", QStringList() << m_pythonScriptPath << "serve");
+}
+
+bool StoryEngineWorker::promoteStandby()
+{
+    if (!m_standbyProcess || m_standbyProcess->state() != QProcess::Running) {
+        return false;
+    }
+
+    QProcess *dead = m_pythonProcess;
+    if (dead) {
+        dead->disconnect(this);
+        dead->kill();
+        dead->deleteLater();
+    }
+
+    m_pythonProcess = m_standbyProcess;
+    m_standbyProcess = nullptr;
+    m_readBuffer.clear();
+    connect(m_pythonProcess,
+            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &StoryEngineWorker::onPrimaryDied);
+
+    // The standby has the engine imported but a stale view of the session:
+    // re-attach the payload ring and replay the last state the player saw
+    // from the in-memory journal, not whatever is on disk
+    setupSharedMemory();
+    if (m_hasJournalState) {
+        syncEngineState(m_journalScene, m_journalMemory);
+    }
+
+    startStandby(); // warm the next standby behind the promoted one
+    return true;
+}
+
+void StoryEngineWorker::onPrimaryDied()
+{
+    // Intentional kills during shutdown or the timeout restart are handled
+    // where they happen; sendEngineRequest recovers in-request deaths itself
+    if (m_shuttingDown || m_requestDepth > 0) {
+        return;
+    }
+
+    if (!promoteStandby()) {
+        emit errorOccurred("Story engine crashed");
+    }
+}
+
+void StoryEngineWorker::setupSharedMemory()
+{
+    m_shmActive = false;
+
+    if (!m_shmData) {
+        QString path = QDir::temp().absoluteFilePath(
+            QString("intothedark_shm_%1.bin").arg(QCoreApplication::applicationPid()));
+        m_shmFile = new QFile(path, this);
+        if (!m_shmFile->open(QIODevice::ReadWrite) || !m_shmFile->resize(kShmSize)) {
+            return;
+        }
+        m_shmData = m_shmFile->map(0, kShmSize);
+        if (!m_shmData) {
+            return;
+        }
+        m_shmSize = kShmSize;
+    }
+
+    // Hand the ring to the engine; if it can't attach we silently stay on
+    // the inline JSON payloads
+    QJsonObject request;
+    request["cmd"] = "shm_init";
+    request["path"] = m_shmFile->fileName();
+
+    QJsonObject result;
+    m_shmActive = sendEngineRequest(request, result) && result["success"].toBool();
+}
+
+bool StoryEngineWorker::shmRegion(const QJsonObject &response, const QString &key,
+                                  quint32 &offset, quint32 &length) const
+{
+    if (!m_shmActive || !m_shmData || !response.contains(key)) {
+        return false;
+    }
+
+    QJsonArray region = response[key].toArray();
+    if (region.size() != 2) {
+        return false;
+    }
+
+    offset = quint32(region[0].toDouble());
+    length = quint32(region[1].toDouble());
+    return qint64(offset) + length <= m_shmSize;
+}
+
+SceneData StoryEngineWorker::readSceneFromShm(quint32 offset, quint32 length) const
+{
+    SceneData scene;
+    scene.sceneId = 0;
+
+    const uchar *p = m_shmData + offset;
+    const uchar *end = p + length;
+    if (p + 20 > end) {
+        return scene;
+    }
+
+    scene.sceneId = qFromLittleEndian<qint32>(p);
+    quint32 backgroundLen = qFromLittleEndian<quint32>(p + 4);
+    quint32 dialogueLen = qFromLittleEndian<quint32>(p + 8);
+    quint32 audioLen = qFromLittleEndian<quint32>(p + 12);
+    qint32 choiceCount = qFromLittleEndian<qint32>(p + 16);
+    p += 20;
+
+    scene.background = takeUtf8(p, end, backgroundLen);
+    scene.dialogue = takeUtf8(p, end, dialogueLen);
+    scene.audioTrack = takeUtf8(p, end, audioLen);
+
+    scene.choices.reserve(choiceCount);
+    for (qint32 i = 0; i < choiceCount && p + 12 <= end; ++i) {
+        quint32 textLen = qFromLittleEndian<quint32>(p);
+        quint32 typeLen = qFromLittleEndian<quint32>(p + 4);
+        qint32 nextScene = qFromLittleEndian<qint32>(p + 8);
+        p += 12;
+        ChoiceData choice;
+        choice.text = takeUtf8(p, end, textLen);
+        choice.memoryType = takeUtf8(p, end, typeLen);
+        choice.nextScene = nextScene;
+        scene.choices.append(std::move(choice));
+    }
+
+    return scene;
+}
+
+MemoryData StoryEngineWorker::readMemoryFromShm(quint32 offset, quint32 length) const
+{
+    MemoryData memory = {};
+
+    const uchar *p = m_shmData + offset;
+    const uchar *end = p + length;
+    if (p + 36 > end) {
+        return memory;
+    }
+
+    memcpy(&memory.kindness, p, 8);
+    memcpy(&memory.obsession, p + 8, 8);
+    memcpy(&memory.truth, p + 16, 8);
+    memcpy(&memory.trust, p + 24, 8);
+    quint32 alignmentLen = qFromLittleEndian<quint32>(p + 32);
+    p += 36;
+    memory.alignment = takeUtf8(p, end, alignmentLen);
+
+    return memory;
+}
+
+SceneData StoryEngineWorker::sceneFromResponse(const QJsonObject &response,
+                                               const QString &inlineKey) const
+{
+    quint32 offset, length;
+    if (shmRegion(response, "shm_scene", offset, length)) {
+        return readSceneFromShm(offset, length);
+    }
+    return parseScene(inlineKey.isEmpty() ? response : response[inlineKey].toObject());
+}
+
+MemoryData StoryEngineWorker::memoryFromResponse(const QJsonObject &response,
+                                                 const QString &inlineKey) const
+{
+    quint32 offset, length;
+    if (shmRegion(response, "shm_memory", offset, length)) {
+        return readMemoryFromShm(offset, length);
+    }
+    return parseMemory(inlineKey.isEmpty() ? response : response[inlineKey].toObject());
+}
+
+// Pops complete lines off `buffer` looking for the response to `requestId`.
+// Stale responses from timed-out or losing hedged requests are discarded by
+// id. Returns true once the request is settled; `failed` distinguishes a
+// parse/engine error from a payload delivered in `result`.
+bool StoryEngineWorker::takeResponse(QByteArray &buffer, int requestId,
+                                     QJsonObject &result, bool &failed,
+                                     bool reportErrors)
+{
+    failed = false;
+
+    int newlinePos;
+    while ((newlinePos = buffer.indexOf('\n')) >= 0) {
+        const QByteArray responseLine = buffer.left(newlinePos);
+        buffer.remove(0, newlinePos + 1);
+
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(responseLine, &parseError);
+
+        if (parseError.error != QJsonParseError::NoError) {
+            if (reportErrors) {
+                emit errorOccurred(QString("JSON parse error: %1").arg(parseError.errorString()));
+            }
+            failed = true;
+            return true;
+        }
+
+        QJsonObject response = doc.object();
+        if (response["id"].toInt() != requestId) {
+            continue;
+        }
+
+        if (response.contains("error")) {
+            if (reportErrors) {
+                emit errorOccurred(QString("Engine error: %1").arg(response["error"].toString()));
+            }
+            failed = true;
+            return true;
+        }
+
+        result = response;
+        return true;
+    }
+
+    return false;
+}
+
+// Spawns a second interpreter for a hedged read. A fresh process loads the
+// current save from disk, so the hedge observes the same state the wedged
+// primary would; it is killed as soon as the race settles.
+QProcess *StoryEngineWorker::startHedgeProcess()
+{
+    QProcess *process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::SeparateChannels);
+    process->start("python3", QStringList() << m_pythonScriptPath << "serve");
+    if (!process->waitForStarted(1000)) {
+        delete process;
+        return nullptr;
+    }
+    return process;
+}
+
+qint64 StoryEngineWorker::latencyP99Ms(const QString &command) const
+{
+    const auto it = m_latencyWindows.constFind(command);
+    if (it == m_latencyWindows.constEnd() || it->size() < 8) {
+        return 0; // not enough history to trust an estimate
+    }
+    QVector<qint64> sorted = *it;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted.at(int(0.99 * (sorted.size() - 1) + 0.5));
+}
+
+void StoryEngineWorker::recordLatency(const QString &command, qint64 elapsedMs)
+{
+    QVector<qint64> &window = m_latencyWindows[command];
+    if (window.size() < kLatencyWindow) {
+        window.append(elapsedMs);
+        return;
+    }
+    int &next = m_latencyNext[command];
+    window[next] = elapsedMs;
+    next = (next + 1) % kLatencyWindow;
+}
+
+bool StoryEngineWorker::isIdempotentCommand(const QString &command)
+{
+    // Only reads that never advance engine state may be retried on a second
+    // worker; a hedged make_choice could apply twice
+    return command == "get_scene" || command == "get_memory"
+        || command == "get_scene_graph" || command == "peek_choice";
+}
+
+bool StoryEngineWorker::sendEngineRequest(QJsonObject request, QJsonObject &result)
+{
+    TraceSpan span("engine.request");
+
+    if (!ensureEngineStarted()) {
+        return false;
+    }
+
+    ++m_requestDepth;
+
+    const QString command = request["cmd"].toString();
+    int requestId = ++m_nextRequestId;
+    request["id"] = requestId;
+
+    QByteArray line = QJsonDocument(request).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    m_pythonProcess->write(line);
+
+    // The deadline adapts to how this command has actually been behaving:
+    // 4x its observed p99, clamped so a consistently fast command fails in
+    // well under a second while a cold window keeps the old flat 5000ms.
+    const qint64 p99Ms = latencyP99Ms(command);
+    const qint64 deadlineMs = p99Ms > 0 ? qBound(qint64(500), p99Ms * 4, qint64(5000)) : 5000;
+    const qint64 stallMs = p99Ms > 0 ? qMax(p99Ms, qint64(100)) : 1000;
+
+    QProcess *hedgeProcess = nullptr;
+    QByteArray hedgeBuffer;
+    int hedgeId = 0;
+    bool stalled = false;
+    bool settled = false;
+    bool failedOver = false;
+    bool ok = false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (timer.elapsed() < deadlineMs) {
+        bool failed = false;
+        if (takeResponse(m_readBuffer, requestId, result, failed, true)) {
+            settled = true;
+            ok = !failed;
+            break;
+        }
+
+        if (hedgeProcess) {
+            hedgeBuffer.append(hedgeProcess->readAllStandardOutput());
+            if (takeResponse(hedgeBuffer, hedgeId, result, failed, false) && !failed) {
+                settled = true;
+                ok = true;
+                break;
+            }
+        }
+
+        // Past the stall point: tell the UI, and race idempotent reads
+        // against a second interpreter — first answer wins
+        if (!stalled && timer.elapsed() >= stallMs) {
+            stalled = true;
+            emit requestStalled(command, int(timer.elapsed()));
+            if (isIdempotentCommand(command)) {
+                hedgeProcess = startHedgeProcess();
+                if (hedgeProcess) {
+                    QJsonObject hedgeRequest = request;
+                    hedgeId = ++m_nextRequestId;
+                    hedgeRequest["id"] = hedgeId;
+                    QByteArray hedgeLine =
+                        QJsonDocument(hedgeRequest).toJson(QJsonDocument::Compact);
+                    hedgeLine.append('\n');
+                    hedgeProcess->write(hedgeLine);
+                }
+            }
+        }
+
+        // A primary that died mid-request fails over to the warm standby at
+        // most once; the request is re-sent with a fresh id on the promoted
+        // process and the clock restarts
+        if (m_pythonProcess->state() != QProcess::Running) {
+            if (failedOver || !promoteStandby()) {
+                break;
+            }
+            failedOver = true;
+            requestId = ++m_nextRequestId;
+            request["id"] = requestId;
+            QByteArray retryLine = QJsonDocument(request).toJson(QJsonDocument::Compact);
+            retryLine.append('\n');
+            m_pythonProcess->write(retryLine);
+            timer.restart();
+            continue;
+        }
+
+        // Short wait slices keep the stall check and hedge poll responsive
+        m_pythonProcess->waitForReadyRead(25);
+        m_readBuffer.append(m_pythonProcess->readAllStandardOutput());
+    }
+
+    if (hedgeProcess) {
+        hedgeProcess->kill();
+        hedgeProcess->waitForFinished(100);
+        delete hedgeProcess;
+    }
+
+    if (settled) {
+        if (ok) {
+            recordLatency(command, timer.elapsed());
+        }
+        --m_requestDepth;
+        return ok;
+    }
+
+    // A timeout leaves the worker in an unknown state; restart it on the
+    // next command rather than trying to resynchronize the stream.
+    m_pythonProcess->kill();
+    m_pythonProcess->waitForFinished(1000);
+    --m_requestDepth;
+    emit errorOccurred("Story engine timeout");
+    return false;
+}
+
+SceneData StoryEngineWorker::parseScene(const QJsonObject &object)
+{
+    // Generated single-pass parser: one walk over the object with every
+    // schema field presence- and type-checked. A misspelled or retyped
+    // field comes back as an empty scene (sceneId 0), which the callers
+    // already treat as a failed payload — not as silently defaulted members.
+    SceneData scene;
+    if (!SceneBindings::parseScene(object, scene)) {
+        return SceneData();
+    }
+    return scene;
+}
+
+MemoryData StoryEngineWorker::parseMemory(const QJsonObject &object)
+{
+    MemoryData memory;
+    if (!SceneBindings::parseMemory(object, memory)) {
+        return MemoryData();
+    }
+    return memory;
+}
+
+QJsonObject StoryEngineWorker::sceneToJson(const SceneData &scene)
+{
+    QJsonObject object;
+    object["scene_id"] = scene.sceneId;
+    object["background"] = scene.background;
+    object["dialogue"] = scene.dialogue;
+    object["audio_track"] = scene.audioTrack;
+
+    QJsonArray choicesArray;
+    for (const ChoiceData &choice : scene.choices) {
+        QJsonObject choiceObj;
+        choiceObj["text"] = choice.text;
+        choiceObj["memory_type"] = choice.memoryType;
+        choiceObj["next_scene"] = choice.nextScene;
+        choicesArray.append(choiceObj);
+    }
+    object["choices"] = choicesArray;
+    return object;
+}
+
+QJsonObject StoryEngineWorker::memoryToJson(const MemoryData &memory)
+{
+    QJsonObject object;
+    object["kindness"] = memory.kindness;
+    object["obsession"] = memory.obsession;
+    object["truth"] = memory.truth;
+    object["trust"] = memory.trust;
+    object["alignment"] = memory.alignment;
+    return object;
+}
+
+void StoryEngineWorker::persistSnapshot(const SceneData &scene, const MemoryData &memory)
+{
+    // This is also the in-memory journal a promoted standby is re-synced
+    // from after a crash
+    m_journalScene = scene;
+    m_journalMemory = memory;
+    m_hasJournalState = true;
+
+    // Small sequential write on the worker thread; the GUI never waits on it
+    QDir().mkpath("save");
+
+    QJsonObject snapshot;
+    snapshot["scene"] = sceneToJson(scene);
+    snapshot["memory"] = memoryToJson(memory);
+
+    QFile file("save/snapshot.json");
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(snapshot).toJson(QJsonDocument::Compact));
+    }
+}
+
+void StoryEngineWorker::fetchScene()
+{
+    noteForegroundActivity();
+
+    if (m_backend == NativeBackend) {
+        emit sceneReady(ensureNativeEngine()->currentScene());
+        return;
+    }
+
+    QJsonObject request;
+    request["cmd"] = "get_scene";
+
+    QJsonObject result;
+    if (sendEngineRequest(request, result)) {
+        emit sceneReady(sceneFromResponse(result, QString()));
+    }
+}
+
+void StoryEngineWorker::fetchSceneGraph()
+{
+    if (m_backend == NativeBackend) {
+        StoryEngine *engine = ensureNativeEngine();
+        emit sceneGraphReady(engine->sceneGraph(), engine->stateDependentScenes());
+        return;
+    }
+
+    QJsonObject request;
+    request["cmd"] = "get_scene_graph";
+
+    QJsonObject result;
+    if (!sendEngineRequest(request, result)) {
+        return;
+    }
+
+    // Scenes arrive as an ordered array starting at scene 1; entry 0 stays
+    // empty so lookups remain a direct subscript
+    SceneGraphIndex graph;
+    graph.append(QList<int>());
+    for (const QJsonValue &sceneValue : result["scenes"].toArray()) {
+        QList<int> targets;
+        for (const QJsonValue &target : sceneValue.toArray()) {
+            targets.append(target.toInt());
+        }
+        graph.append(targets);
+    }
+
+    QList<int> stateDependent;
+    for (const QJsonValue &sceneId : result["state_dependent"].toArray()) {
+        stateDependent.append(sceneId.toInt());
+    }
+    emit sceneGraphReady(graph, stateDependent);
+}
+
+void StoryEngineWorker::fetchMemory()
+{
+    noteForegroundActivity();
+
+    if (m_backend == NativeBackend) {
+        emit memoryReady(ensureNativeEngine()->memoryData());
+        return;
+    }
+
+    QJsonObject request;
+    request["cmd"] = "get_memory";
+
+    QJsonObject result;
+    if (sendEngineRequest(request, result)) {
+        emit memoryReady(memoryFromResponse(result, QString()));
+    }
+}
+
+void StoryEngineWorker::applyChoice(int choiceIndex)
+{
+    TraceSpan span("engine.advance");
+    noteForegroundActivity();
+
+    // Batched transaction: the choice, the resulting scene and the resulting
+    // memory travel through one engine round trip instead of three.
+    if (m_backend == NativeBackend) {
+        SceneData scene;
+        MemoryData memory;
+        bool success = ensureNativeEngine()->advance(choiceIndex, scene, memory);
+        emit choiceApplied(success);
+        if (success) {
+            emit sceneReady(scene);
+            emit memoryReady(memory);
+        }
+        return;
+    }
+
+    QJsonObject request;
+    request["cmd"] = "advance";
+    request["choice_index"] = choiceIndex;
+
+    QJsonObject result;
+    bool success = sendEngineRequest(request, result) && result["success"].toBool();
+    emit choiceApplied(success);
+    if (success) {
+        emit sceneReady(sceneFromResponse(result, "scene"));
+        emit memoryReady(memoryFromResponse(result, "memory"));
+    }
+}
+
+void StoryEngineWorker::speculateChoices(int generation)
+{
+    // Evaluate every possible choice outcome while the player is reading.
+    // Requests queued behind this slot (commits, resets) observe the real,
+    // unmodified engine state.
+    for (int i = 0; i < 4; ++i) {
+        SceneData scene;
+        MemoryData memory;
+
+        if (m_backend == NativeBackend) {
+            if (!ensureNativeEngine()->peekAdvance(i, scene, memory)) {
+                continue;
+            }
+        } else {
+            QJsonObject request;
+            request["cmd"] = "peek_choice";
+            request["choice_index"] = i;
+
+            QJsonObject result;
+            if (!sendEngineRequest(request, result) || !result["success"].toBool()) {
+                continue;
+            }
+            scene = sceneFromResponse(result, "scene");
+            memory = memoryFromResponse(result, "memory");
+        }
+
+        emit speculationReady(generation, i, scene, memory);
+    }
+}
+
+void StoryEngineWorker::commitChoice(int choiceIndex)
+{
+    noteForegroundActivity();
+
+    // The UI already rendered this choice's speculative outcome; commit it
+    // quietly and resync only if the engine disagrees.
+    bool success;
+    if (m_backend == NativeBackend) {
+        success = ensureNativeEngine()->makeChoice(choiceIndex);
+    } else {
+        QJsonObject request;
+        request["cmd"] = "make_choice";
+        request["choice_index"] = choiceIndex;
+
+        QJsonObject result;
+        success = sendEngineRequest(request, result) && result["success"].toBool();
+    }
+
+    if (!success) {
+        emit errorOccurred("Failed to commit speculative choice; resynchronizing");
+        fetchScene();
+        fetchMemory();
+    }
+}
+
+StoryEngine *StoryEngineWorker::sessionEngine(int session)
+{
+    if (session == 0) {
+        return ensureNativeEngine();
+    }
+    StoryEngine *engine = m_sessionEngines.value(session, nullptr);
+    if (!engine) {
+        // Sessions persist separately so attract-mode playthroughs never
+        // touch the live player's save
+        engine = new StoryEngine(QString("save/session_%1.json").arg(session));
+        m_sessionEngines.insert(session, engine);
+    }
+    return engine;
+}
+
+void StoryEngineWorker::setSessionBackground(int session, bool background)
+{
+    if (background) {
+        m_backgroundSessions.insert(session);
+    } else {
+        m_backgroundSessions.remove(session);
+    }
+}
+
+void StoryEngineWorker::dispatchSessionOp(int session, SessionOp op, int arg)
+{
+    if (!m_backgroundSessions.contains(session)) {
+        runSessionOp(session, op, arg);
+        return;
+    }
+
+    // Background work waits for a quiet window; foreground slots push the
+    // window out, so an active player is never queued behind attract mode
+    if (!m_backgroundTimer) {
+        m_backgroundTimer = new QTimer(this);
+        m_backgroundTimer->setSingleShot(true);
+        m_backgroundTimer->setInterval(25);
+        connect(m_backgroundTimer, &QTimer::timeout, this, [this]() {
+            const QList<PendingSessionOp> pending = m_pendingBackground;
+            m_pendingBackground.clear();
+            for (const PendingSessionOp &op : pending) {
+                runSessionOp(op.session, op.op, op.arg);
+            }
+        });
+    }
+    m_pendingBackground.append({session, op, arg});
+    m_backgroundTimer->start();
+}
+
+void StoryEngineWorker::noteForegroundActivity()
+{
+    if (m_backgroundTimer && !m_pendingBackground.isEmpty()) {
+        m_backgroundTimer->start(); // push the quiet window out
+    }
+}
+
+void StoryEngineWorker::runSessionOp(int session, SessionOp op, int arg)
+{
+    if (m_backend == NativeBackend) {
+        StoryEngine *engine = sessionEngine(session);
+        switch (op) {
+        case SessionFetch:
+            break;
+        case SessionChoice:
+            emit sessionChoiceApplied(session, engine->makeChoice(arg));
+            break;
+        case SessionReset:
+            engine->resetGame();
+            break;
+        }
+        emit sessionSceneReady(session, engine->currentScene());
+        return;
+    }
+
+    QJsonObject request;
+    request["session"] = session;
+    switch (op) {
+    case SessionFetch:
+        request["cmd"] = "get_scene";
+        break;
+    case SessionChoice:
+        request["cmd"] = "make_choice";
+        request["choice_index"] = arg;
+        break;
+    case SessionReset:
+        request["cmd"] = "reset_game";
+        break;
+    }
+
+    QJsonObject result;
+    if (!sendEngineRequest(request, result)) {
+        return;
+    }
+    if (op == SessionChoice) {
+        emit sessionChoiceApplied(session, result["success"].toBool());
+    }
+    if (op == SessionFetch) {
+        emit sessionSceneReady(session, sceneFromResponse(result, QString()));
+    } else {
+        QJsonObject sceneRequest;
+        sceneRequest["session"] = session;
+        sceneRequest["cmd"] = "get_scene";
+        QJsonObject sceneResult;
+        if (sendEngineRequest(sceneRequest, sceneResult)) {
+            emit sessionSceneReady(session, sceneFromResponse(sceneResult, QString()));
+        }
+    }
+}
+
+void StoryEngineWorker::fetchSceneFor(int session)
+{
+    dispatchSessionOp(session, SessionFetch, 0);
+}
+
+void StoryEngineWorker::applyChoiceFor(int session, int choiceIndex)
+{
+    dispatchSessionOp(session, SessionChoice, choiceIndex);
+}
+
+void StoryEngineWorker::applyResetFor(int session)
+{
+    dispatchSessionOp(session, SessionReset, 0);
+}
+
+void StoryEngineWorker::restoreState(const SceneData &scene, const MemoryData &memory)
+{
+    // Quiet sync: the interface has already shown the cached history entry,
+    // so success needs no reply — only a failed restore forces a refetch
+    if (m_backend == NativeBackend) {
+        if (!ensureNativeEngine()->restoreState(scene.sceneId, memory)) {
+            emit errorOccurred("Failed to rewind engine state");
+            fetchScene();
+            fetchMemory();
+        }
+        return;
+    }
+
+    m_journalScene = scene;
+    m_journalMemory = memory;
+    m_hasJournalState = true;
+
+    if (!syncEngineState(scene, memory)) {
+        emit errorOccurred("Failed to rewind engine state");
+        fetchScene();
+        fetchMemory();
+    }
+}
+
+bool StoryEngineWorker::syncEngineState(const SceneData &scene, const MemoryData &memory)
+{
+    QJsonObject memoryValues;
+    memoryValues["kindness"] = int(memory.kindness);
+    memoryValues["obsession"] = int(memory.obsession);
+    memoryValues["truth"] = int(memory.truth);
+    memoryValues["trust"] = int(memory.trust);
+
+    QJsonObject request;
+    request["cmd"] = "restore_state";
+    request["scene_id"] = scene.sceneId;
+    request["memory_values"] = memoryValues;
+
+    QJsonObject result;
+    return sendEngineRequest(request, result) && result["success"].toBool();
+}
+
+void StoryEngineWorker::applyReset()
+{
+    if (m_backend == NativeBackend) {
+        emit resetApplied(ensureNativeEngine()->resetGame());
+        return;
+    }
+
+    QJsonObject request;
+    request["cmd"] = "reset_game";
+
+    QJsonObject result;
+    emit resetApplied(sendEngineRequest(request, result) && result["success"].toBool());
+}
+
+StoryEngineInterface::StoryEngineInterface(QObject *parent)
+    : QObject(parent)
+    , m_workerThread(new QThread(this))
+    , m_worker(nullptr)
+    , m_speculationGeneration(0)
+    , m_hasSnapshot(false)
+    , m_liveSceneSeen(false)
+    , m_hasDeliveredMemory(false)
+    , m_historyHead(0)
+    , m_historyCount(0)
+{
+    m_history.resize(kHistoryCapacity);
+
+    loadSnapshot();
+
+    StoryEngineWorker::Backend backend = StoryEngineWorker::NativeBackend;
+    if (QCoreApplication::arguments().contains("--python-engine")) {
+        backend = StoryEngineWorker::PythonBackend;
+    }
+
+    m_worker = new StoryEngineWorker(backend, "save/save.json");
+    m_worker->moveToThread(m_workerThread);
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+    // Requests cross into the worker thread as queued signal deliveries
+    connect(this, &StoryEngineInterface::sceneRequested, m_worker, &StoryEngineWorker::fetchScene);
+    connect(this, &StoryEngineInterface::sceneGraphRequested, m_worker, &StoryEngineWorker::fetchSceneGraph);
+    connect(this, &StoryEngineInterface::memoryRequested, m_worker, &StoryEngineWorker::fetchMemory);
+    connect(this, &StoryEngineInterface::choiceRequested, m_worker, &StoryEngineWorker::applyChoice);
+    connect(this, &StoryEngineInterface::resetRequested, m_worker, &StoryEngineWorker::applyReset);
+    connect(this, &StoryEngineInterface::restoreRequested, m_worker, &StoryEngineWorker::restoreState);
+    connect(this, &StoryEngineInterface::speculationRequested, m_worker, &StoryEngineWorker::speculateChoices);
+    connect(this, &StoryEngineInterface::commitRequested, m_worker, &StoryEngineWorker::commitChoice);
+    connect(this, &StoryEngineInterface::snapshotPersistRequested, m_worker, &StoryEngineWorker::persistSnapshot);
+
+    // Results come back the same way
+    connect(m_worker, &StoryEngineWorker::sceneReady, this, &StoryEngineInterface::onWorkerScene);
+    connect(m_worker, &StoryEngineWorker::sceneGraphReady, this, &StoryEngineInterface::onSceneGraph);
+    connect(m_worker, &StoryEngineWorker::speculationReady, this, &StoryEngineInterface::onSpeculationReady);
+    connect(m_worker, &StoryEngineWorker::memoryReady, this, &StoryEngineInterface::onWorkerMemory);
+    connect(m_worker, &StoryEngineWorker::choiceApplied, this, &StoryEngineInterface::choiceCommitted);
+    connect(m_worker, &StoryEngineWorker::resetApplied, this, &StoryEngineInterface::gameReset);
+    connect(m_worker, &StoryEngineWorker::errorOccurred, this, &StoryEngineInterface::errorOccurred);
+    connect(m_worker, &StoryEngineWorker::requestStalled, this, &StoryEngineInterface::requestStalled);
+
+    m_workerThread->start();
+
+    // The scene graph is static for a given story build; fetch it once so
+    // prefetchers can resolve choice targets without engine round trips
+    emit sceneGraphRequested();
+}
+
+StoryEngineInterface::~StoryEngineInterface()
+{
+    m_workerThread->quit();
+    m_workerThread->wait(3000);
+}
+
+void StoryEngineInterface::loadSnapshot()
+{
+    QFile file("save/snapshot.json");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        return;
+    }
+
+    QJsonObject snapshot = doc.object();
+    m_snapshotScene = StoryEngineWorker::parseScene(snapshot["scene"].toObject());
+    m_snapshotMemory = StoryEngineWorker::parseMemory(snapshot["memory"].toObject());
+    m_hasSnapshot = m_snapshotScene.sceneId > 0;
+}
+
+void StoryEngineInterface::requestScene()
+{
+    // Render the persisted snapshot immediately while the live engine warms
+    // up; the authoritative scene replaces it when it arrives
+    if (!m_liveSceneSeen && m_hasSnapshot) {
+        emit sceneChanged(m_snapshotScene);
+    }
+
+    // Revisits of cached scenes cost nothing: the payload is deterministic
+    // for the cache key, so no engine round trip is needed
+    if (m_liveSceneSeen) {
+        const auto it = m_sceneCache.constFind(sceneCacheKey(m_lastScene.sceneId));
+        if (it != m_sceneCache.constEnd()) {
+            emit sceneChanged(it.value());
+            return;
+        }
+    }
+    emit sceneRequested();
+}
+
+void StoryEngineInterface::requestMemory()
+{
+    if (!m_liveSceneSeen && m_hasSnapshot) {
+        emit memoryUpdated(m_snapshotMemory);
+    }
+    emit memoryRequested();
+}
+
+void StoryEngineInterface::makeChoice(int choiceIndex)
+{
+    pushHistory(choiceIndex);
+
+    if (m_speculative.contains(choiceIndex)) {
+        // Serve the precomputed outcome instantly; the engine commit happens
+        // asynchronously behind it. commitRequested is queued first so the
+        // follow-up speculation sees the post-commit state. take() moves the
+        // outcome out of the table instead of copying it — onWorkerScene
+        // clears the table anyway.
+        const QPair<SceneData, MemoryData> outcome = m_speculative.take(choiceIndex);
+        emit commitRequested(choiceIndex);
+        emit choiceCommitted(true);
+        onWorkerScene(outcome.first);
+        deliverMemory(outcome.second);
+        return;
+    }
+
+    // Revisit fast path on a speculation miss: the choice's target is known
+    // from the scene graph, and if its payload is cached as static the scene
+    // shows immediately — the engine commit and the authoritative memory
+    // refresh run behind it in the worker's queue.
+    const QList<int> targets = choiceTargets(m_lastScene.sceneId);
+    if (m_liveSceneSeen && choiceIndex >= 0 && choiceIndex < targets.size()) {
+        const int target = targets.at(choiceIndex);
+        if (!m_stateDependentScenes.contains(target)) {
+            const auto it = m_sceneCache.constFind(sceneCacheKey(target));
+            if (it != m_sceneCache.constEnd()) {
+                emit commitRequested(choiceIndex);
+                emit memoryRequested();
+                emit choiceCommitted(true);
+                onWorkerScene(it.value());
+                return;
+            }
+        }
+    }
+
+    emit choiceRequested(choiceIndex);
+}
+
+void StoryEngineInterface::onWorkerScene(const SceneData &scene)
+{
+    // A new authoritative scene invalidates cached speculative outcomes;
+    // late results from the previous scene are dropped by generation
+    m_speculative.clear();
+    ++m_speculationGeneration;
+    m_liveSceneSeen = true;
+    m_lastScene = scene;
+    m_sceneCache.insert(sceneCacheKey(scene.sceneId), scene);
+    emit sceneChanged(scene);
+    emit speculationRequested(m_speculationGeneration);
+}
+
+void StoryEngineInterface::onSceneGraph(const SceneGraphIndex &graph,
+                                        const QList<int> &stateDependentScenes)
+{
+    m_sceneGraph = graph;
+    m_stateDependentScenes = QSet<int>(stateDependentScenes.begin(),
+                                       stateDependentScenes.end());
+}
+
+QList<int> StoryEngineInterface::choiceTargets(int sceneId) const
+{
+    if (sceneId < 1 || sceneId >= m_sceneGraph.size()) {
+        return QList<int>();
+    }
+    return m_sceneGraph.at(sceneId);
+}
+
+quint64 StoryEngineInterface::sceneCacheKey(int sceneId) const
+{
+    // Static scenes hash to their id alone and stay cached forever; scenes
+    // the engine declared state-dependent fold in the memory state
+    quint64 key = quint64(sceneId) << 32;
+    if (m_stateDependentScenes.contains(sceneId)) {
+        quint64 hash = 1469598103934665603ULL; // FNV-1a
+        const int values[] = {int(m_lastMemory.kindness), int(m_lastMemory.obsession),
+                              int(m_lastMemory.truth), int(m_lastMemory.trust)};
+        for (int value : values) {
+            hash = (hash ^ quint64(value)) * 1099511628211ULL;
+        }
+        key |= hash & 0xFFFFFFFF;
+    }
+    return key;
+}
+
+void StoryEngineInterface::pushHistory(int choiceIndex)
+{
+    if (!m_liveSceneSeen) {
+        return; // nothing trustworthy to restore to yet
+    }
+
+    HistoryEntry entry;
+    entry.scene = m_lastScene;
+    entry.memory = m_lastMemory;
+    entry.choiceIndex = choiceIndex;
+
+    const int slot = (m_historyHead + m_historyCount) % kHistoryCapacity;
+    m_history[slot] = entry;
+    if (m_historyCount < kHistoryCapacity) {
+        ++m_historyCount;
+    } else {
+        m_historyHead = (m_historyHead + 1) % kHistoryCapacity;
+    }
+}
+
+QList<StoryEngineInterface::HistoryEntry> StoryEngineInterface::history() const
+{
+    QList<HistoryEntry> entries;
+    entries.reserve(m_historyCount);
+    for (int i = 0; i < m_historyCount; ++i) {
+        entries.append(m_history.at((m_historyHead + i) % kHistoryCapacity));
+    }
+    return entries;
+}
+
+void StoryEngineInterface::rewind()
+{
+    if (m_historyCount == 0) {
+        return;
+    }
+
+    const int slot = (m_historyHead + m_historyCount - 1) % kHistoryCapacity;
+    // The entry is dead once popped, so its payload can be moved out of the
+    // ring rather than copied
+    HistoryEntry entry = std::move(m_history[slot]);
+    --m_historyCount;
+
+    // Restore locally first — the player sees the previous scene instantly —
+    // then sync the engine with one quiet restore request
+    m_speculative.clear();
+    ++m_speculationGeneration;
+    m_lastScene = std::move(entry.scene);
+    emit restoreRequested(m_lastScene, entry.memory);
+    emit sceneChanged(m_lastScene);
+    deliverMemory(entry.memory);
+    emit speculationRequested(m_speculationGeneration);
+}
+
+void StoryEngineInterface::deliverMemory(const MemoryData &memory)
+{
+    // Mark only the stats that actually moved since the last delivery, so
+    // the memory bar can skip untouched gauges entirely
+    MemoryData delivered = memory;
+    if (m_hasDeliveredMemory) {
+        delivered.dirty = 0;
+        if (delivered.kindness != m_lastMemory.kindness)
+            delivered.dirty |= MemoryData::KindnessDirty;
+        if (delivered.obsession != m_lastMemory.obsession)
+            delivered.dirty |= MemoryData::ObsessionDirty;
+        if (delivered.truth != m_lastMemory.truth)
+            delivered.dirty |= MemoryData::TruthDirty;
+        if (delivered.trust != m_lastMemory.trust)
+            delivered.dirty |= MemoryData::TrustDirty;
+        if (delivered.alignment != m_lastMemory.alignment)
+            delivered.dirty |= MemoryData::AlignmentDirty;
+    }
+    m_lastMemory = memory;
+    m_hasDeliveredMemory = true;
+
+    emit memoryUpdated(delivered);
+
+    // Keep the launch snapshot in step with what the player last saw
+    if (m_liveSceneSeen) {
+        emit snapshotPersistRequested(m_lastScene, memory);
+    }
+}
+
+void StoryEngineInterface::onWorkerMemory(const MemoryData &memory)
+{
+    deliverMemory(memory);
+}
+
+void StoryEngineInterface::onSpeculationReady(int generation, int choiceIndex,
+                                              const SceneData &scene, const MemoryData &memory)
+{
+    if (generation != m_speculationGeneration) {
+        return;
+    }
+    m_speculative.insert(choiceIndex, qMakePair(scene, memory));
+}
+
+void StoryEngineInterface::resetGame()
+{
+    m_historyHead = 0;
+    m_historyCount = 0;
+
+    // The engine rewinds to scene 1, so everything derived from pre-reset
+    // state is stale: the last live scene (which requestScene would
+    // otherwise serve from cache), the speculative outcomes (which would
+    // commit a pre-reset choice against the reset engine), and the launch
+    // snapshot. Bumping the generation drops in-flight speculation results;
+    // the post-reset scene is fetched authoritatively from the worker.
+    m_liveSceneSeen = false;
+    m_lastScene = SceneData();
+    m_speculative.clear();
+    ++m_speculationGeneration;
+    m_hasSnapshot = false;
+
+    emit resetRequested();
+}
+
+AttractSession::AttractSession(StoryEngineInterface *primary, int sessionId,
+                               QObject *parent)
+    : QObject(parent)
+    , m_sessionId(sessionId)
+{
+    StoryEngineWorker *worker = primary->worker();
+
+    connect(this, &AttractSession::backgroundFlagRequested,
+            worker, &StoryEngineWorker::setSessionBackground);
+    connect(this, &AttractSession::sceneRequested,
+            worker, &StoryEngineWorker::fetchSceneFor);
+    connect(this, &AttractSession::choiceRequested,
+            worker, &StoryEngineWorker::applyChoiceFor);
+    connect(this, &AttractSession::resetRequested,
+            worker, &StoryEngineWorker::applyResetFor);
+
+    connect(worker, &StoryEngineWorker::sessionSceneReady,
+            this, [this](int session, const SceneData &scene) {
+        if (session == m_sessionId) {
+            emit sceneChanged(scene);
+        }
+    });
+    connect(worker, &StoryEngineWorker::sessionChoiceApplied,
+            this, [this](int session, bool success) {
+        if (session == m_sessionId) {
+            emit choiceCommitted(success);
+        }
+    });
+
+    emit backgroundFlagRequested(m_sessionId, true);
+}
@@ -0,0 +1,301 @@
+#ifndef ENGINE_INTERFACE_H
+#define ENGINE_INTERFACE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QPair>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+#include "story_engine.h"
+
+class QFile;
+class QProcess;
+
+// Backend worker owning the story engine. It lives on a dedicated thread so
+// engine calls, save-file I/O and Python round trips never block the GUI.
+class StoryEngineWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // The native engine is the default; the Python subprocess backend is kept
+    // as a compatibility fallback selected with --python-engine.
+    enum Backend {
+        NativeBackend,
+        PythonBackend
+    };
+
+    StoryEngineWorker(Backend backend, const QString &savePath);
+    ~StoryEngineWorker();
+
+public slots:
+    void fetchScene();
+    void fetchSceneGraph();
+    void fetchMemory();
+    void applyChoice(int choiceIndex);
+    void applyReset();
+    void restoreState(const SceneData &scene, const MemoryData &memory);
+
+    // Session-multiplexed operations: additional sessions share this worker,
+    // its engine process and the loaded scene graph. Background sessions are
+    // deferred behind a quiet window so they never delay the live player.
+    void setSessionBackground(int session, bool background);
+    void fetchSceneFor(int session);
+    void applyChoiceFor(int session, int choiceIndex);
+    void applyResetFor(int session);
+    void speculateChoices(int generation);
+    void commitChoice(int choiceIndex);
+    void persistSnapshot(const SceneData &scene, const MemoryData &memory);
+
+signals:
+    void sceneReady(const SceneData &scene);
+    void sceneGraphReady(const SceneGraphIndex &graph,
+                         const QList<int> &stateDependentScenes);
+    void memoryReady(const MemoryData &memory);
+    void choiceApplied(bool success);
+    void resetApplied(bool success);
+    void speculationReady(int generation, int choiceIndex,
+                          const SceneData &scene, const MemoryData &memory);
+    void errorOccurred(const QString &message);
+    // A command has run past its observed p99; lets the UI show progress
+    // instead of freezing until the adaptive deadline fires
+    void requestStalled(const QString &command, int elapsedMs);
+    void sessionSceneReady(int session, const SceneData &scene);
+    void sessionChoiceApplied(int session, bool success);
+
+public:
+    static SceneData parseScene(const QJsonObject &object);
+    static MemoryData parseMemory(const QJsonObject &object);
+    static QJsonObject sceneToJson(const SceneData &scene);
+    static QJsonObject memoryToJson(const MemoryData &memory);
+
+private:
+    enum SessionOp {
+        SessionFetch,
+        SessionChoice,
+        SessionReset
+    };
+
+    StoryEngine *ensureNativeEngine();
+    StoryEngine *sessionEngine(int session);
+    void runSessionOp(int session, SessionOp op, int arg);
+    void dispatchSessionOp(int session, SessionOp op, int arg);
+    void noteForegroundActivity();
+    bool ensureEngineStarted();
+    void startStandby();
+    bool promoteStandby();
+    bool syncEngineState(const SceneData &scene, const MemoryData &memory);
+    bool sendEngineRequest(QJsonObject request, QJsonObject &result);
+    bool takeResponse(QByteArray &buffer, int requestId, QJsonObject &result,
+                      bool &failed, bool reportErrors);
+    QProcess *startHedgeProcess();
+    qint64 latencyP99Ms(const QString &command) const;
+    void recordLatency(const QString &command, qint64 elapsedMs);
+    static bool isIdempotentCommand(const QString &command);
+    QString getPythonScriptPath();
+    void setupSharedMemory();
+    bool shmRegion(const QJsonObject &response, const QString &key,
+                   quint32 &offset, quint32 &length) const;
+    SceneData readSceneFromShm(quint32 offset, quint32 length) const;
+    MemoryData readMemoryFromShm(quint32 offset, quint32 length) const;
+    SceneData sceneFromResponse(const QJsonObject &response, const QString &inlineKey) const;
+    MemoryData memoryFromResponse(const QJsonObject &response, const QString &inlineKey) const;
+
+    Backend m_backend;
+    QString m_savePath;
+    StoryEngine *m_nativeEngine;
+
+    // Extra sessions multiplexed over this worker (session 0 is the live
+    // player and uses the members above)
+    QHash<int, StoryEngine *> m_sessionEngines;
+    QSet<int> m_backgroundSessions;
+    struct PendingSessionOp {
+        int session;
+        SessionOp op;
+        int arg;
+    };
+    QList<PendingSessionOp> m_pendingBackground;
+    QTimer *m_backgroundTimer;
+    QProcess *m_pythonProcess;
+    QString m_pythonScriptPath;
+    QByteArray m_readBuffer;
+    int m_nextRequestId;
+
+    // Warm standby interpreter, pre-spawned so a crashed primary can be
+    // replaced without paying the startup cost; promoted on failover and
+    // re-synced from the in-memory journal below
+    QProcess *m_standbyProcess;
+    bool m_shuttingDown;
+    int m_requestDepth;
+    SceneData m_journalScene;
+    MemoryData m_journalMemory;
+    bool m_hasJournalState;
+
+private slots:
+    void onPrimaryDied();
+
+private:
+
+    // Sliding latency window per command; p99 over it drives the stall
+    // threshold and the adaptive deadline in sendEngineRequest
+    static const int kLatencyWindow = 64;
+    QHash<QString, QVector<qint64>> m_latencyWindows;
+    QHash<QString, int> m_latencyNext;
+
+    // Shared-memory payload ring: the Python worker writes scene/memory
+    // payloads in a fixed binary layout and responses carry only offsets
+    QFile *m_shmFile;
+    uchar *m_shmData;
+    qint64 m_shmSize;
+    bool m_shmActive;
+};
+
+// GUI-thread facade over StoryEngineWorker. The request methods post work to
+// the worker thread and return immediately; results arrive asynchronously via
+// the sceneChanged/memoryUpdated/choiceCommitted/gameReset signals.
+class StoryEngineInterface : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StoryEngineInterface(QObject *parent = nullptr);
+    ~StoryEngineInterface();
+
+    void requestScene();
+    void requestMemory();
+    void makeChoice(int choiceIndex);
+    void resetGame();
+
+    // Shared by companion sessions multiplexed over this connection
+    StoryEngineWorker *worker() const { return m_worker; }
+
+    // O(1) lookup into the scene-graph index fetched at startup; empty until
+    // the worker has delivered the graph
+    QList<int> choiceTargets(int sceneId) const;
+    SceneGraphIndex sceneGraph() const { return m_sceneGraph; }
+
+    // Bounded choice history for the backlog view and O(1) rewind
+    struct HistoryEntry {
+        SceneData scene;
+        MemoryData memory;
+        int choiceIndex;
+    };
+
+    bool canRewind() const { return m_historyCount > 0; }
+    // Scenes already played, oldest first, served from the cached payloads
+    // without touching the engine
+    QList<HistoryEntry> history() const;
+    // Steps back one choice: a local state restore plus one quiet engine sync
+    void rewind();
+
+signals:
+    void sceneChanged(const SceneData &scene);
+    void memoryUpdated(const MemoryData &memory);
+    void choiceCommitted(bool success);
+    void gameReset(bool success);
+    void errorOccurred(const QString &message);
+    // Forwarded from the worker when an engine command runs long
+    void requestStalled(const QString &command, int elapsedMs);
+
+    // Internal request channel into the worker thread
+    void sceneRequested();
+    void sceneGraphRequested();
+    void memoryRequested();
+    void choiceRequested(int choiceIndex);
+    void resetRequested();
+    void restoreRequested(const SceneData &scene, const MemoryData &memory);
+    void speculationRequested(int generation);
+    void commitRequested(int choiceIndex);
+    void snapshotPersistRequested(const SceneData &scene, const MemoryData &memory);
+
+private slots:
+    void onWorkerScene(const SceneData &scene);
+    void onWorkerMemory(const MemoryData &memory);
+    void onSpeculationReady(int generation, int choiceIndex,
+                            const SceneData &scene, const MemoryData &memory);
+    void onSceneGraph(const SceneGraphIndex &graph,
+                      const QList<int> &stateDependentScenes);
+
+private:
+    void loadSnapshot();
+    void deliverMemory(const MemoryData &memory);
+
+    QThread *m_workerThread;
+    StoryEngineWorker *m_worker;
+
+    // Last persisted scene/memory, rendered instantly at launch while the
+    // live engine warms up in the background
+    SceneData m_snapshotScene;
+    MemoryData m_snapshotMemory;
+    bool m_hasSnapshot;
+    bool m_liveSceneSeen;
+    SceneData m_lastScene;
+
+    // Previous delivered memory payload, diffed to set per-stat dirty flags
+    MemoryData m_lastMemory;
+    bool m_hasDeliveredMemory;
+
+    // Speculative outcomes for the current scene's choices, keyed by choice
+    // index; invalidated whenever an authoritative scene arrives
+    QHash<int, QPair<SceneData, MemoryData>> m_speculative;
+    int m_speculationGeneration;
+
+    quint64 sceneCacheKey(int sceneId) const;
+
+    // Static story structure, fetched once from the worker
+    SceneGraphIndex m_sceneGraph;
+
+    // Response cache keyed by (sceneId, state hash); scenes not declared
+    // state-dependent hash to their id alone and never expire
+    QHash<quint64, SceneData> m_sceneCache;
+    QSet<int> m_stateDependentScenes;
+
+    // Fixed-capacity ring of played choices; the oldest entries fall off
+    // once the bound is reached
+    static const int kHistoryCapacity = 64;
+    QVector<HistoryEntry> m_history;
+    int m_historyHead;  // index of the oldest entry
+    int m_historyCount;
+    void pushHistory(int choiceIndex);
+};
+
+// Additional engine session multiplexed over a primary interface's worker,
+// sharing its engine process, thread and loaded scene graph instead of
+// spawning a second full instance. The session is registered as background
+// priority in the worker, so it never delays the live player's requests.
+// Used by kiosk attract mode.
+class AttractSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    AttractSession(StoryEngineInterface *primary, int sessionId,
+                   QObject *parent = nullptr);
+
+    int sessionId() const { return m_sessionId; }
+
+    void requestScene() { emit sceneRequested(m_sessionId); }
+    void makeChoice(int choiceIndex) { emit choiceRequested(m_sessionId, choiceIndex); }
+    void resetGame() { emit resetRequested(m_sessionId); }
+
+signals:
+    void sceneChanged(const SceneData &scene);
+    void choiceCommitted(bool success);
+
+    // Internal request channel into the shared worker thread
+    void backgroundFlagRequested(int session, bool background);
+    void sceneRequested(int session);
+    void choiceRequested(int session, int choiceIndex);
+    void resetRequested(int session);
+
+private:
+    int m_sessionId;
+};
+
+#endif // ENGINE_INTERFACE_H
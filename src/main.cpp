@@ -4,259 +4,27 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QPushButton>
-#include <QTextEdit>
-#include <QProgressBar>
-#include <QGraphicsView>
-#include <QGraphicsScene>
-#include <QGraphicsPixmapItem>
 #include <QTimer>
-#include <QPropertyAnimation>
-#include <QGraphicsOpacityEffect>
-#include <QProcess>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QFile>
-#include <QDir>
-#include <QStandardPaths>
 #include <QMessageBox>
+#include <QDateTime>
+#include <QPainter>
+#include <QSet>
+#include <QShortcut>
 #include <QDebug>
-#include <QThread>
 #include <QFont>
 #include <QFontDatabase>
 #include <QPalette>
+#include <QRandomGenerator>
 #include <QStyleFactory>
 
-class StoryEngineInterface : public QObject
-{
-    Q_OBJECT
-
-public:
-    explicit StoryEngineInterface(QObject *parent = nullptr);
-    
-    struct SceneData {
-        int sceneId;
-        QString background;
-        QString dialogue;
-        QList<QPair<QString, QString>> choices; // text, memory_type
-        QString audioTrack;
-    };
-    
-    struct MemoryData {
-        double kindness;
-        double obsession;
-        double truth;
-        double trust;
-        QString alignment;
-    };
-    
-    SceneData getCurrentScene();
-    MemoryData getMemoryData();
-    bool makeChoice(int choiceIndex);
-    bool resetGame();
-    
-signals:
-    void sceneChanged();
-    void memoryUpdated();
-    void errorOccurred(const QString &message);
-
-private:
-    QProcess *m_pythonProcess;
-    QString m_pythonScriptPath;
-    QString m_savePath;
-    
-    bool executePythonCommand(const QString &command, QJsonObject &result);
-    QString getPythonScriptPath();
-};
-
-StoryEngineInterface::StoryEngineInterface(QObject *parent)
-    : QObject(parent)
-    , m_pythonProcess(nullptr)
-    , m_savePath("save/save.json")
-{
-    m_pythonScriptPath = getPythonScriptPath();
-}
-
-QString StoryEngineInterface::getPythonScriptPath()
-{
-    QDir appDir(QApplication::applicationDirPath());
-    QString scriptPath = appDir.absoluteFilePath("../python_backend/story_engine.py");
-    
-    if (!QFile::exists(scriptPath)) {
-        // Try relative to current working directory
-        scriptPath = "python_backend/story_engine.py";
-    }
-    
-    return scriptPath;
-}
-
-bool StoryEngineInterface::executePythonCommand(const QString &command, QJsonObject &result)
-{
-    if (!m_pythonProcess) {
-        m_pythonProcess = new QProcess(this);
-        m_pythonProcess->setProcessChannelMode(QProcess::MergedChannels);
-    }
-    
-    QStringList args;
-    args << m_pythonScriptPath << command;
-    
-    m_pythonProcess->start("python3", args);
-    
-    if (!m_pythonProcess->waitForFinished(5000)) {
-        emit errorOccurred("Python process timeout");
-        return false;
-    }
-    
-    if (m_pythonProcess->exitCode() != 0) {
-        QString error = m_pythonProcess->readAllStandardError();
-        emit errorOccurred(QString("Python error: %1").arg(error));
-        return false;
-    }
-    
-    QByteArray output = m_pythonProcess->readAllStandardOutput();
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(output, &parseError);
-    
-    if (parseError.error != QJsonParseError::NoError) {
-        emit errorOccurred(QString("JSON parse error: %1").arg(parseError.errorString()));
-        return false;
-    }
-    
-    result = doc.object();
-    return true;
-}
-
-StoryEngineInterface::SceneData StoryEngineInterface::getCurrentScene()
-{
-    SceneData scene;
-    QJsonObject result;
-    
-    if (executePythonCommand("get_scene", result)) {
-        scene.sceneId = result["scene_id"].toInt();
-        scene.background = result["background"].toString();
-        scene.dialogue = result["dialogue"].toString();
-        scene.audioTrack = result["audio_track"].toString();
-        
-        QJsonArray choicesArray = result["choices"].toArray();
-        for (const QJsonValue &value : choicesArray) {
-            QJsonObject choiceObj = value.toObject();
-            scene.choices.append(qMakePair(
-                choiceObj["text"].toString(),
-                choiceObj["memory_type"].toString()
-            ));
-        }
-    }
-    
-    return scene;
-}
-
-StoryEngineInterface::MemoryData StoryEngineInterface::getMemoryData()
-{
-    MemoryData memory;
-    QJsonObject result;
-    
-    if (executePythonCommand("get_memory", result)) {
-        memory.kindness = result["kindness"].toDouble();
-        memory.obsession = result["obsession"].toDouble();
-        memory.truth = result["truth"].toDouble();
-        memory.trust = result["trust"].toDouble();
-        memory.alignment = result["alignment"].toString();
-    }
-    
-    return memory;
-}
-
-bool StoryEngineInterface::makeChoice(int choiceIndex)
-{
-    QJsonObject result;
-    return executePythonCommand(QString("make_choice %1").arg(choiceIndex), result);
-}
-
-bool StoryEngineInterface::resetGame()
-{
-    QJsonObject result;
-    return executePythonCommand("reset_game", result);
-}
-
-class CutsceneWidget : public QGraphicsView
-{
-    Q_OBJECT
-
-public:
-    explicit CutsceneWidget(QWidget *parent = nullptr);
-    void setCutscene(const QString &imagePath);
-    void fadeIn();
-    void fadeOut();
-
-private:
-    QGraphicsScene *m_scene;
-    QGraphicsPixmapItem *m_pixmapItem;
-    QGraphicsOpacityEffect *m_opacityEffect;
-    QPropertyAnimation *m_fadeAnimation;
-};
-
-CutsceneWidget::CutsceneWidget(QWidget *parent)
-    : QGraphicsView(parent)
-    , m_scene(new QGraphicsScene(this))
-    , m_pixmapItem(nullptr)
-    , m_opacityEffect(new QGraphicsOpacityEffect(this))
-    , m_fadeAnimation(new QPropertyAnimation(m_opacityEffect, "opacity", this))
-{
-    setScene(m_scene);
-    setRenderHint(QPainter::Antialiasing);
-    setRenderHint(QPainter::SmoothPixmapTransform);
-    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    
-    // Set up fade animation
-    m_fadeAnimation->setDuration(1000);
-    m_fadeAnimation->setEasingCurve(QEasingCurve::InOutQuad);
-    
-    setGraphicsEffect(m_opacityEffect);
-    m_opacityEffect->setOpacity(0.0);
-}
-
-void CutsceneWidget::setCutscene(const QString &imagePath)
-{
-    QPixmap pixmap(imagePath);
-    
-    if (pixmap.isNull()) {
-        // Create placeholder if image doesn't exist
-        pixmap = QPixmap(800, 600);
-        pixmap.fill(QColor(40, 40, 40));
-        
-        QPainter painter(&pixmap);
-        painter.setPen(QPen(QColor(100, 100, 100), 2));
-        painter.setFont(QFont("Arial", 24));
-        painter.drawText(pixmap.rect(), Qt::AlignCenter, 
-                        QString("Cutscene: %1\n(Placeholder)").arg(QFileInfo(imagePath).baseName()));
-    }
-    
-    if (m_pixmapItem) {
-        m_scene->removeItem(m_pixmapItem);
-        delete m_pixmapItem;
-    }
-    
-    m_pixmapItem = m_scene->addPixmap(pixmap);
-    m_scene->setSceneRect(pixmap.rect());
-    
-    // Scale to fit widget
-    fitInView(m_scene->sceneRect(), Qt::KeepAspectRatio);
-}
-
-void CutsceneWidget::fadeIn()
-{
-    m_fadeAnimation->setStartValue(0.0);
-    m_fadeAnimation->setEndValue(1.0);
-    m_fadeAnimation->start();
-}
-
-void CutsceneWidget::fadeOut()
-{
-    m_fadeAnimation->setStartValue(1.0);
-    m_fadeAnimation->setEndValue(0.0);
-    m_fadeAnimation->start();
-}
+#include "asset_manifest.h"
+#include "audio_engine.h"
+#include "cutscene_widget.h"
+#include "dialogue_widget.h"
+#include "engine_interface.h"
+#include "pixmap_cache.h"
+#include "styled_widgets.h"
+#include "trace_recorder.h"
 
 class MemoryBar : public QWidget
 {
@@ -264,81 +32,116 @@ class MemoryBar : public QWidget
 
 public:
     explicit MemoryBar(QWidget *parent = nullptr);
-    void updateMemory(const StoryEngineInterface::MemoryData &data);
+    void updateMemory(const MemoryData &data);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private slots:
+    void animateGauges();
 
 private:
     QVBoxLayout *m_layout;
+    QTimer *m_animationTimer;
     QLabel *m_alignmentLabel;
-    QProgressBar *m_kindnessBar;
-    QProgressBar *m_obsessionBar;
-    QProgressBar *m_truthBar;
-    QProgressBar *m_trustBar;
+    MemoryGauge *m_kindnessBar;
+    MemoryGauge *m_obsessionBar;
+    MemoryGauge *m_truthBar;
+    MemoryGauge *m_trustBar;
 };
 
 MemoryBar::MemoryBar(QWidget *parent)
     : QWidget(parent)
     , m_layout(new QVBoxLayout(this))
     , m_alignmentLabel(new QLabel("Alignment: Neutral", this))
-    , m_kindnessBar(new QProgressBar(this))
-    , m_obsessionBar(new QProgressBar(this))
-    , m_truthBar(new QProgressBar(this))
-    , m_trustBar(new QProgressBar(this))
+    , m_kindnessBar(new MemoryGauge(QColor(100, 200, 100), this))   // Green
+    , m_obsessionBar(new MemoryGauge(QColor(200, 100, 100), this))  // Red
+    , m_truthBar(new MemoryGauge(QColor(100, 100, 200), this))      // Blue
+    , m_trustBar(new MemoryGauge(QColor(200, 200, 100), this))      // Yellow
+    , m_animationTimer(new QTimer(this))
 {
+    // One timer animates every dirty gauge; four bars never schedule four
+    // independent repaint cascades
+    m_animationTimer->setInterval(16);
+    connect(m_animationTimer, &QTimer::timeout, this, &MemoryBar::animateGauges);
+
     m_layout->setContentsMargins(5, 5, 5, 5);
     m_layout->setSpacing(5);
     
-    // Set up alignment label
-    m_alignmentLabel->setStyleSheet("color: #E0E0E0; font-weight: bold;");
+    // Label colors come from the palette, set once — no stylesheet cascade
+    QPalette labelPalette = m_alignmentLabel->palette();
+    labelPalette.setColor(QPalette::WindowText, QColor(0xE0, 0xE0, 0xE0));
+
+    QFont boldFont = m_alignmentLabel->font();
+    boldFont.setBold(true);
+    m_alignmentLabel->setFont(boldFont);
+    m_alignmentLabel->setPalette(labelPalette);
     m_layout->addWidget(m_alignmentLabel);
     
-    // Set up progress bars
-    QList<QProgressBar*> bars = {m_kindnessBar, m_obsessionBar, m_truthBar, m_trustBar};
+    // Set up memory gauges
+    QList<MemoryGauge*> bars = {m_kindnessBar, m_obsessionBar, m_truthBar, m_trustBar};
     QStringList labels = {"Kindness", "Obsession", "Truth", "Trust"};
-    QList<QColor> colors = {
-        QColor(100, 200, 100),  // Kindness - Green
-        QColor(200, 100, 100),  // Obsession - Red
-        QColor(100, 100, 200),  // Truth - Blue
-        QColor(200, 200, 100)   // Trust - Yellow
-    };
     
     for (int i = 0; i < bars.size(); ++i) {
         QHBoxLayout *barLayout = new QHBoxLayout();
         
         QLabel *label = new QLabel(labels[i] + ":", this);
-        label->setStyleSheet("color: #E0E0E0; min-width: 80px;");
+        label->setPalette(labelPalette);
+        label->setMinimumWidth(80);
         label->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
         
-        bars[i]->setRange(0, 100);
-        bars[i]->setValue(0);
-        bars[i]->setStyleSheet(QString(
-            "QProgressBar {"
-            "    border: 1px solid #666;"
-            "    border-radius: 3px;"
-            "    text-align: center;"
-            "    background-color: #333;"
-            "}"
-            "QProgressBar::chunk {"
-            "    background-color: %1;"
-            "    border-radius: 2px;"
-            "}"
-        ).arg(colors[i].name()));
-        
         barLayout->addWidget(label);
         barLayout->addWidget(bars[i]);
         m_layout->addLayout(barLayout);
     }
     
     setFixedWidth(250);
-    setStyleSheet("background-color: #2A2A2A; border: 1px solid #666; border-radius: 5px;");
 }
 
-void MemoryBar::updateMemory(const StoryEngineInterface::MemoryData &data)
+void MemoryBar::paintEvent(QPaintEvent *)
 {
-    m_alignmentLabel->setText(QString("Alignment: %1").arg(data.alignment));
-    m_kindnessBar->setValue(static_cast<int>(data.kindness));
-    m_obsessionBar->setValue(static_cast<int>(data.obsession));
-    m_truthBar->setValue(static_cast<int>(data.truth));
-    m_trustBar->setValue(static_cast<int>(data.trust));
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(QColor(0x66, 0x66, 0x66), 1));
+    painter.setBrush(QColor(0x2A, 0x2A, 0x2A));
+    painter.drawRoundedRect(rect().adjusted(0, 0, -1, -1), 5, 5);
+}
+
+void MemoryBar::updateMemory(const MemoryData &data)
+{
+    // Untouched stats are skipped entirely; dirty ones glide to their new
+    // value on the shared animation timer
+    if (data.dirty & MemoryData::AlignmentDirty) {
+        m_alignmentLabel->setText(QString("Alignment: %1").arg(data.alignment));
+    }
+    if (data.dirty & MemoryData::KindnessDirty) {
+        m_kindnessBar->animateTo(static_cast<int>(data.kindness));
+    }
+    if (data.dirty & MemoryData::ObsessionDirty) {
+        m_obsessionBar->animateTo(static_cast<int>(data.obsession));
+    }
+    if (data.dirty & MemoryData::TruthDirty) {
+        m_truthBar->animateTo(static_cast<int>(data.truth));
+    }
+    if (data.dirty & MemoryData::TrustDirty) {
+        m_trustBar->animateTo(static_cast<int>(data.trust));
+    }
+
+    if (data.dirty & ~MemoryData::AlignmentDirty) {
+        m_animationTimer->start();
+    }
+}
+
+void MemoryBar::animateGauges()
+{
+    bool animating = false;
+    const QList<MemoryGauge*> bars = {m_kindnessBar, m_obsessionBar, m_truthBar, m_trustBar};
+    for (MemoryGauge *bar : bars) {
+        animating = bar->stepTowardTarget() || animating;
+    }
+    if (!animating) {
+        m_animationTimer->stop();
+    }
 }
 
 class MainWindow : public QMainWindow
@@ -350,34 +153,77 @@ public:
 
 private slots:
     void onChoiceClicked();
-    void onSceneChanged();
-    void onMemoryUpdated();
+    void onSceneChanged(const SceneData &scene);
+    void onMemoryUpdated(const MemoryData &memory);
+    void onChoiceCommitted(bool success);
+    void onGameReset(bool success);
     void onErrorOccurred(const QString &message);
+    void onRequestStalled(const QString &command, int elapsedMs);
     void onResetGame();
+    void onRewind();
+    void onShowBacklog();
+    void dumpTrace();
+    void startAttractMode();
+    void advanceAttract();
+    void onAttractScene(const SceneData &scene);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private:
     void setupUI();
-    void updateScene();
-    void updateMemory();
+    void setChoicesEnabled(bool enabled);
     void setupDarkTheme();
+    void stopAttractMode();
+    void clearBusyCursor();
     
     StoryEngineInterface *m_storyEngine;
+    PixmapCache *m_pixmapCache;
+    AudioEngine *m_audioEngine;
+    AssetManifest *m_assetManifest;
     CutsceneWidget *m_cutsceneWidget;
-    QTextEdit *m_dialogueText;
+    DialogueWidget *m_dialogueText;
     QList<QPushButton*> m_choiceButtons;
     MemoryBar *m_memoryBar;
     QPushButton *m_resetButton;
-    
-    StoryEngineInterface::SceneData m_currentScene;
+    QPushButton *m_rewindButton;
+    QPushButton *m_backlogButton;
+
+    // Attract mode: a second engine session multiplexed over the same
+    // worker, playing itself at background priority when the kiosk idles
+    AttractSession *m_attractSession;
+    QTimer *m_idleTimer;
+    QTimer *m_attractTimer;
+    bool m_attractActive;
+    bool m_busyCursorShown;
+
+    // Reused across scenes so per-click label formatting allocates only
+    // when a label outgrows the retained capacity
+    QString m_choiceLabelBuffer;
+
+    SceneData m_currentScene;
 };
 
+// How long the kiosk sits untouched before attract mode starts, and how
+// long attract mode lingers on a scene before picking the next choice
+static const int kAttractIdleMs = 90 * 1000;
+static const int kAttractAdvanceMs = 8 * 1000;
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_storyEngine(new StoryEngineInterface(this))
+    , m_pixmapCache(new PixmapCache(this))
+    , m_audioEngine(new AudioEngine(this))
+    , m_assetManifest(new AssetManifest(this))
     , m_cutsceneWidget(nullptr)
     , m_dialogueText(nullptr)
     , m_memoryBar(nullptr)
     , m_resetButton(nullptr)
+    , m_attractSession(nullptr)
+    , m_idleTimer(new QTimer(this))
+    , m_attractTimer(new QTimer(this))
+    , m_attractActive(false)
+    , m_busyCursorShown(false)
 {
     setupDarkTheme();
     setupUI();
@@ -385,11 +231,107 @@ MainWindow::MainWindow(QWidget *parent)
     // Connect signals
     connect(m_storyEngine, &StoryEngineInterface::sceneChanged, this, &MainWindow::onSceneChanged);
     connect(m_storyEngine, &StoryEngineInterface::memoryUpdated, this, &MainWindow::onMemoryUpdated);
+    connect(m_storyEngine, &StoryEngineInterface::choiceCommitted, this, &MainWindow::onChoiceCommitted);
+    connect(m_storyEngine, &StoryEngineInterface::gameReset, this, &MainWindow::onGameReset);
     connect(m_storyEngine, &StoryEngineInterface::errorOccurred, this, &MainWindow::onErrorOccurred);
-    
-    // Load initial scene
-    updateScene();
-    updateMemory();
+    connect(m_storyEngine, &StoryEngineInterface::requestStalled, this, &MainWindow::onRequestStalled);
+
+    // Inventory the shipped assets in parallel; once the decoded sizes are
+    // known, budget for roughly half of them resident at once — eviction by
+    // scene-graph distance keeps the reachable half
+    connect(m_assetManifest, &AssetManifest::scanFinished,
+            this, [this](int, qint64 totalImageBytes) {
+        const int totalKb = int(totalImageBytes / 1024);
+        if (totalKb > 0) {
+            m_pixmapCache->setMaxCostKb(qMax(16 * 1024, totalKb / 2));
+        }
+    });
+    m_assetManifest->scan();
+
+    // Hidden hotkey: dump the flight recorder for a kiosk in the field
+    QShortcut *traceShortcut = new QShortcut(QKeySequence("Ctrl+Shift+T"), this);
+    connect(traceShortcut, &QShortcut::activated, this, &MainWindow::dumpTrace);
+
+    // Any user input anywhere in the window resets the idle clock and
+    // ends attract mode if it is running
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(kAttractIdleMs);
+    connect(m_idleTimer, &QTimer::timeout, this, &MainWindow::startAttractMode);
+    m_attractTimer->setInterval(kAttractAdvanceMs);
+    connect(m_attractTimer, &QTimer::timeout, this, &MainWindow::advanceAttract);
+    qApp->installEventFilter(this);
+    m_idleTimer->start();
+
+    // Request the initial scene; it arrives via sceneChanged without
+    // blocking the first paint of the window
+    m_storyEngine->requestScene();
+    m_storyEngine->requestMemory();
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseMove:
+    case QEvent::TouchBegin:
+        if (m_attractActive) {
+            stopAttractMode();
+        }
+        m_idleTimer->start();
+        break;
+    default:
+        break;
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::startAttractMode()
+{
+    // Session 1 shares the primary interface's worker, engine process,
+    // scene graph and pixmap cache; only its save state is its own
+    if (!m_attractSession) {
+        m_attractSession = new AttractSession(m_storyEngine, 1, this);
+        connect(m_attractSession, &AttractSession::sceneChanged,
+                this, &MainWindow::onAttractScene);
+    }
+
+    m_attractActive = true;
+    setChoicesEnabled(false);
+    m_attractSession->resetGame();
+    m_attractSession->requestScene();
+    m_attractTimer->start();
+}
+
+void MainWindow::advanceAttract()
+{
+    if (m_currentScene.choices.isEmpty()) {
+        m_attractSession->resetGame();
+        m_attractSession->requestScene();
+        return;
+    }
+    m_attractSession->makeChoice(
+        QRandomGenerator::global()->bounded(m_currentScene.choices.size()));
+}
+
+void MainWindow::onAttractScene(const SceneData &scene)
+{
+    // Session responses can still arrive after the player interrupts;
+    // the live scene has already been restored by then
+    if (m_attractActive) {
+        onSceneChanged(scene);
+    }
+}
+
+void MainWindow::stopAttractMode()
+{
+    m_attractTimer->stop();
+    m_attractActive = false;
+    setChoicesEnabled(true);
+    // The player's own scene is still cached in the interface, so this
+    // redisplays it without an engine round trip
+    m_storyEngine->requestScene();
+    m_storyEngine->requestMemory();
 }
 
 void MainWindow::setupDarkTheme()
@@ -431,48 +373,24 @@ void MainWindow::setupUI()
     
     // Cutscene widget
     m_cutsceneWidget = new CutsceneWidget(this);
+    m_cutsceneWidget->setPixmapCache(m_pixmapCache);
     m_cutsceneWidget->setMinimumSize(800, 600);
     leftLayout->addWidget(m_cutsceneWidget);
     
-    // Dialogue text
-    m_dialogueText = new QTextEdit(this);
+    // Dialogue text: typewriter reveal over a per-scene cached layout
+    m_dialogueText = new DialogueWidget(this);
+    m_dialogueText->setMinimumHeight(150);
     m_dialogueText->setMaximumHeight(150);
-    m_dialogueText->setReadOnly(true);
-    m_dialogueText->setStyleSheet(
-        "QTextEdit {"
-        "    background-color: rgba(0, 0, 0, 150);"
-        "    color: #E0E0E0;"
-        "    border: 1px solid #666;"
-        "    border-radius: 5px;"
-        "    padding: 10px;"
-        "    font-size: 14px;"
-        "}"
-    );
+    m_dialogueText->setDialogue(0, "Entering the dark...");
     leftLayout->addWidget(m_dialogueText);
     
     // Choice buttons
     QHBoxLayout *choiceLayout = new QHBoxLayout();
     for (int i = 0; i < 4; ++i) {
-        QPushButton *button = new QPushButton(this);
+        StyledButton *button = new StyledButton(StyledButton::choiceColors(), this);
         button->setMinimumHeight(50);
-        button->setStyleSheet(
-            "QPushButton {"
-            "    background-color: #444;"
-            "    color: #E0E0E0;"
-            "    border: 1px solid #666;"
-            "    border-radius: 5px;"
-            "    padding: 10px;"
-            "    font-size: 12px;"
-            "}"
-            "QPushButton:hover {"
-            "    background-color: #555;"
-            "    border-color: #888;"
-            "}"
-            "QPushButton:pressed {"
-            "    background-color: #333;"
-            "}"
-        );
         connect(button, &QPushButton::clicked, this, &MainWindow::onChoiceClicked);
+        button->setVisible(false); // shown when the first scene arrives
         m_choiceButtons.append(button);
         choiceLayout->addWidget(button);
     }
@@ -489,47 +407,69 @@ void MainWindow::setupUI()
     
     rightLayout->addStretch();
     
+    // Rewind and backlog, fed from the interface's cached history
+    m_rewindButton = new StyledButton(StyledButton::resetColors(), this);
+    m_rewindButton->setText("Rewind");
+    m_rewindButton->setMinimumHeight(40);
+    connect(m_rewindButton, &QPushButton::clicked, this, &MainWindow::onRewind);
+    rightLayout->addWidget(m_rewindButton);
+
+    m_backlogButton = new StyledButton(StyledButton::resetColors(), this);
+    m_backlogButton->setText("Backlog");
+    m_backlogButton->setMinimumHeight(40);
+    connect(m_backlogButton, &QPushButton::clicked, this, &MainWindow::onShowBacklog);
+    rightLayout->addWidget(m_backlogButton);
+
     // Reset button
-    m_resetButton = new QPushButton("Reset Game", this);
-    m_resetButton->setStyleSheet(
-        "QPushButton {"
-        "    background-color: #666;"
-        "    color: #E0E0E0;"
-        "    border: 1px solid #888;"
-        "    border-radius: 5px;"
-        "    padding: 10px;"
-        "    font-size: 14px;"
-        "}"
-        "QPushButton:hover {"
-        "    background-color: #777;"
-        "}"
-    );
+    m_resetButton = new StyledButton(StyledButton::resetColors(), this);
+    m_resetButton->setText("Reset Game");
+    m_resetButton->setMinimumHeight(40);
     connect(m_resetButton, &QPushButton::clicked, this, &MainWindow::onResetGame);
     rightLayout->addWidget(m_resetButton);
     
     mainLayout->addLayout(rightLayout, 1);
 }
 
-void MainWindow::updateScene()
+void MainWindow::onSceneChanged(const SceneData &scene)
 {
-    m_currentScene = m_storyEngine->getCurrentScene();
-    
+    TraceSpan span("ui.scene_changed");
+
+    clearBusyCursor();
+
+    // Feed the residency manager its eviction inputs: story structure and
+    // where the player now is (the graph is implicitly shared, so handing
+    // it over every scene costs a refcount)
+    m_pixmapCache->setSceneGraph(m_storyEngine->sceneGraph());
+    m_pixmapCache->setCurrentScene(scene.sceneId);
+
+    m_currentScene = scene;
+
     // Update cutscene
-    QString imagePath = QString("assets/cutscenes/%1").arg(m_currentScene.background);
+    // setCutscene starts the old-to-new crossfade itself; an explicit
+    // fadeIn() here would wipe the outgoing pixmap and dip to black
+    QString imagePath = QStringLiteral("assets/cutscenes/") + m_currentScene.background;
     m_cutsceneWidget->setCutscene(imagePath);
-    m_cutsceneWidget->fadeIn();
     
+    // Crossfade to the scene's track; the native path replaces the Python
+    // audio subprocess round trip
+    if (!m_currentScene.audioTrack.isEmpty()) {
+        m_audioEngine->setTrack(AudioEngine::trackPath(m_currentScene.audioTrack));
+    }
+
     // Update dialogue
-    m_dialogueText->setPlainText(m_currentScene.dialogue);
+    m_dialogueText->setDialogue(m_currentScene.sceneId, m_currentScene.dialogue);
     
-    // Update choice buttons
+    // Update choice buttons. The label is assembled by appending into a
+    // buffer that keeps its capacity between scenes; arg() would parse the
+    // format string and allocate intermediates on every click.
     for (int i = 0; i < m_choiceButtons.size() && i < m_currentScene.choices.size(); ++i) {
-        const auto &choice = m_currentScene.choices[i];
-        QString buttonText = QString("%1\n(+%2 %3)")
-            .arg(choice.first)
-            .arg(5) // Memory value is hardcoded in Python for now
-            .arg(choice.second);
-        m_choiceButtons[i]->setText(buttonText);
+        const ChoiceData &choice = m_currentScene.choices[i];
+        m_choiceLabelBuffer.resize(0);
+        m_choiceLabelBuffer += choice.text;
+        m_choiceLabelBuffer += QStringLiteral("\n(+5 "); // Memory value is hardcoded in Python for now
+        m_choiceLabelBuffer += choice.memoryType;
+        m_choiceLabelBuffer += QLatin1Char(')');
+        m_choiceButtons[i]->setText(m_choiceLabelBuffer);
         m_choiceButtons[i]->setVisible(true);
     }
     
@@ -537,41 +477,133 @@ void MainWindow::updateScene()
     for (int i = m_currentScene.choices.size(); i < m_choiceButtons.size(); ++i) {
         m_choiceButtons[i]->setVisible(false);
     }
+
+    // Predictively decode the backgrounds actually reachable from this
+    // scene while the player reads; every choice now carries its resolved
+    // target scene id
+    QSet<int> targets;
+    for (const ChoiceData &choice : scene.choices) {
+        targets.insert(choice.nextScene);
+    }
+    QStringList preloadPaths;
+    for (int target : targets) {
+        const QString imagePath = QStringLiteral("assets/cutscenes/cutscene%1.jpg").arg(target);
+        if (m_assetManifest->isScanned() && !m_assetManifest->exists(imagePath)) {
+            // Known missing: render its placeholder now, off the display path
+            m_cutsceneWidget->prerenderPlaceholder(imagePath);
+        } else {
+            preloadPaths << m_cutsceneWidget->resolveVariant(imagePath);
+        }
+        m_audioEngine->prefetch(
+            AudioEngine::trackPath(QStringLiteral("audio%1.wav").arg(target)));
+    }
+    m_pixmapCache->preload(preloadPaths);
 }
 
-void MainWindow::updateMemory()
+void MainWindow::onMemoryUpdated(const MemoryData &memory)
 {
-    StoryEngineInterface::MemoryData memoryData = m_storyEngine->getMemoryData();
-    m_memoryBar->updateMemory(memoryData);
+    clearBusyCursor();
+    m_memoryBar->updateMemory(memory);
+}
+
+void MainWindow::onRequestStalled(const QString &command, int elapsedMs)
+{
+    // The engine is running long but has not failed yet; show that the app
+    // is waiting rather than frozen. The cursor clears when any result or
+    // error arrives.
+    Q_UNUSED(command);
+    Q_UNUSED(elapsedMs);
+    if (!m_busyCursorShown) {
+        m_busyCursorShown = true;
+        QApplication::setOverrideCursor(Qt::BusyCursor);
+    }
+}
+
+void MainWindow::clearBusyCursor()
+{
+    if (m_busyCursorShown) {
+        m_busyCursorShown = false;
+        QApplication::restoreOverrideCursor();
+    }
+}
+
+void MainWindow::setChoicesEnabled(bool enabled)
+{
+    for (QPushButton *button : m_choiceButtons) {
+        button->setEnabled(enabled);
+    }
 }
 
 void MainWindow::onChoiceClicked()
 {
     QPushButton *button = qobject_cast<QPushButton*>(sender());
     if (!button) return;
-    
+
     int choiceIndex = m_choiceButtons.indexOf(button);
     if (choiceIndex >= 0 && choiceIndex < m_currentScene.choices.size()) {
-        if (m_storyEngine->makeChoice(choiceIndex)) {
-            updateScene();
-            updateMemory();
-        }
+        // Guard against double-clicks while the engine commits the choice;
+        // the UI stays responsive and results arrive via sceneChanged
+        setChoicesEnabled(false);
+        m_storyEngine->makeChoice(choiceIndex);
     }
 }
 
-void MainWindow::onSceneChanged()
+void MainWindow::onChoiceCommitted(bool success)
 {
-    updateScene();
+    // The new scene and memory arrive with the same engine transaction via
+    // sceneChanged/memoryUpdated, so nothing needs to be re-requested here
+    Q_UNUSED(success);
+    setChoicesEnabled(true);
 }
 
-void MainWindow::onMemoryUpdated()
+void MainWindow::onErrorOccurred(const QString &message)
 {
-    updateMemory();
+    clearBusyCursor();
+    // A field report of "it froze" is only actionable with the trace of the
+    // seconds leading up to it
+    dumpTrace();
+    QMessageBox::warning(this, "Error", message);
 }
 
-void MainWindow::onErrorOccurred(const QString &message)
+void MainWindow::dumpTrace()
 {
-    QMessageBox::warning(this, "Error", message);
+    const QString path = QString("trace_%1.json")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    if (TraceRecorder::instance()->exportChromeTrace(path)) {
+        qDebug() << "Flight recorder dumped to" << path;
+    }
+}
+
+void MainWindow::onRewind()
+{
+    // O(1): the interface restores its cached history entry locally and
+    // syncs the engine once in the background
+    if (m_storyEngine->canRewind()) {
+        m_storyEngine->rewind();
+    }
+}
+
+void MainWindow::onShowBacklog()
+{
+    const QList<StoryEngineInterface::HistoryEntry> entries = m_storyEngine->history();
+    if (entries.isEmpty()) {
+        QMessageBox::information(this, "Backlog", "No choices made yet.");
+        return;
+    }
+
+    // Built entirely from cached SceneData — no engine round trips
+    QString backlog;
+    for (const StoryEngineInterface::HistoryEntry &entry : entries) {
+        const QString choiceText =
+            entry.choiceIndex >= 0 && entry.choiceIndex < entry.scene.choices.size()
+                ? entry.scene.choices.at(entry.choiceIndex).text
+                : QString();
+        backlog += QString("Scene %1: %2\n> %3\n\n")
+            .arg(entry.scene.sceneId)
+            .arg(entry.scene.dialogue.section('\n', 0, 0))
+            .arg(choiceText);
+    }
+    QMessageBox::information(this, "Backlog", backlog.trimmed());
 }
 
 void MainWindow::onResetGame()
@@ -581,13 +613,18 @@ void MainWindow::onResetGame()
                                    QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        if (m_storyEngine->resetGame()) {
-            updateScene();
-            updateMemory();
-            QMessageBox::information(this, "Game Reset", "Game has been reset to the beginning.");
-        } else {
-            QMessageBox::warning(this, "Reset Failed", "Failed to reset the game.");
-        }
+        m_storyEngine->resetGame();
+    }
+}
+
+void MainWindow::onGameReset(bool success)
+{
+    if (success) {
+        m_storyEngine->requestScene();
+        m_storyEngine->requestMemory();
+        QMessageBox::information(this, "Game Reset", "Game has been reset to the beginning.");
+    } else {
+        QMessageBox::warning(this, "Reset Failed", "Failed to reset the game.");
     }
 }
 
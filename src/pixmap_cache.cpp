@@ -0,0 +1,289 @@
+#include "pixmap_cache.h"
+
+#include "trace_recorder.h"
+
+#include <QPainter>
+
+namespace {
+
+// Images at or below this edge length are packed into shared atlas pages.
+// Only genuinely small art qualifies: cutscene frames — including the
+// downscaled kiosk variants — stay standalone, because atlas pages are
+// never freed and atlased entries are invisible to eviction, and a cache
+// hit on an atlased entry pays a copy out of the page.
+const int kAtlasSlotMax = 256;
+const int kAtlasPageSize = 2048;
+const int kAtlasPageKb = kAtlasPageSize * kAtlasPageSize * 4 / 1024;
+
+// Graph walk depth cap: beyond this many choices ahead, every frame is
+// considered equally cold
+const int kDistanceCap = 8;
+
+} // namespace
+
+void PixmapDecoder::decode(const QString &path)
+{
+    TraceSpan span("pixmap.decode");
+
+    // QImage decodes safely off the GUI thread; a failed load travels back
+    // as a null image so the cache can clear its pending state
+    emit decoded(path, QImage(path));
+}
+
+PixmapCache::PixmapCache(QObject *parent, int maxCostKb)
+    : QObject(parent)
+    , m_maxCostKb(maxCostKb)
+    , m_residentKb(0)
+    , m_useCounter(0)
+    , m_currentScene(0)
+    , m_decodeThread(new QThread(this))
+    , m_decoder(new PixmapDecoder)
+{
+    m_decoder->moveToThread(m_decodeThread);
+    connect(m_decodeThread, &QThread::finished, m_decoder, &QObject::deleteLater);
+    connect(this, &PixmapCache::decodeRequested, m_decoder, &PixmapDecoder::decode);
+    connect(m_decoder, &PixmapDecoder::decoded, this, &PixmapCache::onImageDecoded);
+    m_decodeThread->start(QThread::LowPriority);
+}
+
+PixmapCache::~PixmapCache()
+{
+    m_decodeThread->quit();
+    m_decodeThread->wait(3000);
+}
+
+bool PixmapCache::contains(const QString &path) const
+{
+    return m_entries.contains(path);
+}
+
+int PixmapCache::sceneIdForPath(const QString &path)
+{
+    // assets/cutscenes/cutscene7.jpg and its cutscene7_1280.jpg variants
+    // both belong to scene 7
+    const int base = path.lastIndexOf(QLatin1String("cutscene"));
+    if (base < 0) {
+        return 0;
+    }
+    int i = base + 8;
+    int sceneId = 0;
+    while (i < path.size() && path.at(i).isDigit()) {
+        sceneId = sceneId * 10 + path.at(i).digitValue();
+        ++i;
+    }
+    return sceneId;
+}
+
+bool PixmapCache::insertIntoAtlas(const QString &path, const QPixmap &pixmap, Entry &entry)
+{
+    if (pixmap.width() > kAtlasSlotMax || pixmap.height() > kAtlasSlotMax) {
+        return false;
+    }
+
+    // Shelf packing: entries fill the current row left to right; a row that
+    // cannot fit the next entry closes and a new one opens below it
+    if (m_atlases.isEmpty()
+        || (m_atlases.last().shelfX + pixmap.width() > kAtlasPageSize
+            && m_atlases.last().shelfY + m_atlases.last().shelfHeight
+                   + pixmap.height() > kAtlasPageSize)) {
+        Atlas atlas;
+        atlas.page = QPixmap(kAtlasPageSize, kAtlasPageSize);
+        atlas.page.fill(Qt::transparent);
+        m_atlases.append(atlas);
+        m_residentKb += kAtlasPageKb;
+    }
+
+    Atlas &atlas = m_atlases.last();
+    if (atlas.shelfX + pixmap.width() > kAtlasPageSize) {
+        atlas.shelfY += atlas.shelfHeight;
+        atlas.shelfX = 0;
+        atlas.shelfHeight = 0;
+    }
+
+    const QRect rect(atlas.shelfX, atlas.shelfY, pixmap.width(), pixmap.height());
+    QPainter painter(&atlas.page);
+    painter.drawPixmap(rect.topLeft(), pixmap);
+    painter.end();
+
+    atlas.shelfX += pixmap.width();
+    atlas.shelfHeight = qMax(atlas.shelfHeight, pixmap.height());
+
+    entry.atlasIndex = m_atlases.size() - 1;
+    entry.atlasRect = rect;
+    return true;
+}
+
+void PixmapCache::insert(const QString &path, const QPixmap &pixmap)
+{
+    Entry entry;
+    entry.sceneId = sceneIdForPath(path);
+    entry.lastUse = ++m_useCounter;
+
+    // Small images share atlas pages; their cost is carried by the page.
+    // Full cutscene frames stay standalone so they can be evicted alone.
+    if (!insertIntoAtlas(path, pixmap, entry)) {
+        entry.pixmap = pixmap;
+        entry.costKb = qMax(1, int(qint64(pixmap.width()) * pixmap.height()
+                                   * pixmap.depth() / 8 / 1024));
+        m_residentKb += entry.costKb;
+    }
+
+    m_entries.insert(path, entry);
+    evictToBudget();
+    recordResidency();
+}
+
+void PixmapCache::setMaxCostKb(int maxCostKb)
+{
+    m_maxCostKb = maxCostKb;
+    evictToBudget();
+    recordResidency();
+}
+
+void PixmapCache::setSceneGraph(const SceneGraphIndex &graph)
+{
+    m_sceneGraph = graph;
+}
+
+void PixmapCache::setCurrentScene(int sceneId)
+{
+    m_currentScene = sceneId;
+}
+
+// Choices ahead of the current scene before `sceneId` can be shown, from a
+// depth-capped breadth-first walk of the scene-graph index; unreachable or
+// unknown scenes rank coldest
+int PixmapCache::predictedDistance(int sceneId) const
+{
+    if (sceneId <= 0 || m_currentScene <= 0
+        || m_currentScene >= m_sceneGraph.size()) {
+        return kDistanceCap;
+    }
+    if (sceneId == m_currentScene) {
+        return 0;
+    }
+
+    QSet<int> visited;
+    visited.insert(m_currentScene);
+    QList<int> frontier;
+    frontier.append(m_currentScene);
+
+    for (int depth = 1; depth <= kDistanceCap && !frontier.isEmpty(); ++depth) {
+        QList<int> next;
+        for (int scene : frontier) {
+            if (scene < 0 || scene >= m_sceneGraph.size()) {
+                continue;
+            }
+            for (int target : m_sceneGraph.at(scene)) {
+                if (target == sceneId) {
+                    return depth;
+                }
+                if (!visited.contains(target)) {
+                    visited.insert(target);
+                    next.append(target);
+                }
+            }
+        }
+        frontier = next;
+    }
+
+    return kDistanceCap;
+}
+
+void PixmapCache::evictToBudget()
+{
+    // Atlas pages are shared and bounded, so eviction works the standalone
+    // frames, where nearly all of the memory lives
+    while (m_residentKb > m_maxCostKb) {
+        QString victim;
+        int victimDistance = -1;
+        quint64 victimUse = 0;
+
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            if (it->atlasIndex >= 0) {
+                continue;
+            }
+            const int distance = predictedDistance(it->sceneId);
+            if (distance > victimDistance
+                || (distance == victimDistance && it->lastUse < victimUse)) {
+                victim = it.key();
+                victimDistance = distance;
+                victimUse = it->lastUse;
+            }
+        }
+
+        if (victim.isEmpty()) {
+            break; // nothing evictable; the budget is smaller than the atlases
+        }
+
+        m_residentKb -= m_entries.value(victim).costKb;
+        m_entries.remove(victim);
+    }
+}
+
+void PixmapCache::recordResidency() const
+{
+    // A counter track beside the spans: residency over time lines up with
+    // the decodes and scene changes that caused it
+    TraceRecorder::instance()->counter("pixmap.resident_kb", m_residentKb);
+}
+
+QPixmap PixmapCache::pixmap(const QString &path)
+{
+    auto it = m_entries.find(path);
+    if (it != m_entries.end()) {
+        it->lastUse = ++m_useCounter;
+        if (it->atlasIndex >= 0) {
+            // Copying out of the page is the compatibility path; draw-time
+            // callers should use atlasRegion() and stay zero-copy
+            return m_atlases.at(it->atlasIndex).page.copy(it->atlasRect);
+        }
+        return it->pixmap;
+    }
+
+    // Cache miss: decode synchronously as a fallback so callers always get
+    // an answer; preloaded paths should never reach this branch
+    QPixmap loaded(path);
+    if (!loaded.isNull()) {
+        insert(path, loaded);
+    }
+    return loaded;
+}
+
+bool PixmapCache::atlasRegion(const QString &path, QPixmap &atlas, QRect &rect)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end() || it->atlasIndex < 0) {
+        return false;
+    }
+    it->lastUse = ++m_useCounter;
+    atlas = m_atlases.at(it->atlasIndex).page;
+    rect = it->atlasRect;
+    return true;
+}
+
+void PixmapCache::preload(const QStringList &paths)
+{
+    for (const QString &path : paths) {
+        if (path.isEmpty() || m_entries.contains(path) || m_pending.contains(path)) {
+            continue;
+        }
+        m_pending.insert(path);
+        emit decodeRequested(path);
+    }
+}
+
+void PixmapCache::onImageDecoded(const QString &path, const QImage &image)
+{
+    m_pending.remove(path);
+
+    if (image.isNull()) {
+        return;
+    }
+
+    // A synchronous miss may have decoded this path in the meantime
+    if (!m_entries.contains(path)) {
+        insert(path, QPixmap::fromImage(image));
+    }
+    emit pixmapLoaded(path);
+}
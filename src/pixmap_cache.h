@@ -0,0 +1,115 @@
+#ifndef PIXMAP_CACHE_H
+#define PIXMAP_CACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QPixmap>
+#include <QRect>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+#include "scene_data.h"
+
+// Decodes image files on a background thread. QPixmap is GUI-thread-only, so
+// the decoder hands back QImage and the cache converts on delivery.
+class PixmapDecoder : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void decode(const QString &path);
+
+signals:
+    void decoded(const QString &path, const QImage &image);
+};
+
+// Residency manager for decoded cutscene memory. All decoded pixels live
+// here under one byte budget: full-size cutscene frames as standalone
+// pixmaps, small images shelf-packed into shared atlas pages. When the
+// budget is exceeded, standalone frames are evicted by predicted-next-use
+// distance — a breadth-first walk of the scene-graph index from the current
+// scene, so the frame the player is least likely to reach soon goes first —
+// with least-recent use as the tiebreak. Current residency is reported to
+// the flight recorder as a counter track.
+class PixmapCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PixmapCache(QObject *parent = nullptr, int maxCostKb = 256 * 1024);
+    ~PixmapCache();
+
+    // Returns the cached pixmap, decoding synchronously on a miss. Atlased
+    // entries are copied out; draw-time callers that can handle a source
+    // rect should prefer atlasRegion().
+    QPixmap pixmap(const QString &path);
+
+    // Zero-copy access for atlased images: returns the shared atlas page
+    // and the entry's rect within it, or false when the path is not atlased
+    bool atlasRegion(const QString &path, QPixmap &atlas, QRect &rect);
+
+    // Resize the budget once the real decoded sizes are known
+    void setMaxCostKb(int maxCostKb);
+
+    // Eviction inputs: the static story structure and where the player is
+    void setSceneGraph(const SceneGraphIndex &graph);
+    void setCurrentScene(int sceneId);
+
+    // Queues background decodes for paths not already cached or pending
+    void preload(const QStringList &paths);
+
+    bool contains(const QString &path) const;
+    qint64 residentKb() const { return m_residentKb; }
+
+signals:
+    void pixmapLoaded(const QString &path);
+
+    // Internal request channel into the decoder thread
+    void decodeRequested(const QString &path);
+
+private slots:
+    void onImageDecoded(const QString &path, const QImage &image);
+
+private:
+    struct Entry {
+        QPixmap pixmap;      // standalone image; null when atlased
+        int atlasIndex = -1; // page in m_atlases when atlased
+        QRect atlasRect;
+        int costKb = 0;      // 0 for atlased entries (the page carries it)
+        quint64 lastUse = 0;
+        int sceneId = 0;     // parsed from the file name, 0 when unknown
+    };
+
+    // One shelf-packed atlas page; rows grow downward, entries rightward
+    struct Atlas {
+        QPixmap page;
+        int shelfX = 0;
+        int shelfY = 0;
+        int shelfHeight = 0;
+    };
+
+    void insert(const QString &path, const QPixmap &pixmap);
+    bool insertIntoAtlas(const QString &path, const QPixmap &pixmap, Entry &entry);
+    void evictToBudget();
+    int predictedDistance(int sceneId) const;
+    void recordResidency() const;
+    static int sceneIdForPath(const QString &path);
+
+    QHash<QString, Entry> m_entries;
+    QList<Atlas> m_atlases;
+    qint64 m_maxCostKb;
+    qint64 m_residentKb;
+    quint64 m_useCounter;
+    SceneGraphIndex m_sceneGraph;
+    int m_currentScene;
+
+    QSet<QString> m_pending;
+    QThread *m_decodeThread;
+    PixmapDecoder *m_decoder;
+};
+
+#endif // PIXMAP_CACHE_H
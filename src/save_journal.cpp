@@ -0,0 +1,96 @@
+#include "save_journal.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+SaveJournal::SaveJournal(const QString &savePath)
+    : m_recordCount(0)
+{
+    if (!savePath.isEmpty()) {
+        m_journalPath = savePath + ".journal";
+    }
+}
+
+bool SaveJournal::ensureOpen()
+{
+    if (m_journalPath.isEmpty()) {
+        return false;
+    }
+    if (m_file && m_file->isOpen()) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(m_journalPath).path());
+
+    m_file = QSharedPointer<QFile>::create(m_journalPath);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        m_file.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SaveJournal::appendChoice(int choiceIndex)
+{
+    if (!ensureOpen()) {
+        return false;
+    }
+
+    QJsonObject record;
+    record["op"] = "choice";
+    record["idx"] = choiceIndex;
+
+    QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    if (m_file->write(line) != line.size()) {
+        return false;
+    }
+    m_file->flush();
+    ++m_recordCount;
+    return true;
+}
+
+QList<int> SaveJournal::replayChoices() const
+{
+    QList<int> choices;
+    if (m_journalPath.isEmpty()) {
+        return choices;
+    }
+
+    QFile file(m_journalPath);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return choices;
+    }
+
+    // A record interrupted by a crash fails to parse and is dropped along
+    // with everything after it; the journal is valid up to that point
+    while (!file.atEnd()) {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(file.readLine(), &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+            break;
+        }
+        QJsonObject record = doc.object();
+        if (record["op"].toString() == "choice") {
+            choices.append(record["idx"].toInt(-1));
+        }
+    }
+    return choices;
+}
+
+void SaveJournal::clear()
+{
+    if (m_journalPath.isEmpty()) {
+        return;
+    }
+    if (m_file && m_file->isOpen()) {
+        m_file->close();
+    }
+    m_file.clear();
+    QFile::remove(m_journalPath);
+    m_recordCount = 0;
+}
@@ -0,0 +1,45 @@
+#ifndef SAVE_JOURNAL_H
+#define SAVE_JOURNAL_H
+
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+
+class QFile;
+
+// Append-only save journal living beside the save.json snapshot.
+//
+// Each committed choice appends one compact record — a few dozen bytes of
+// sequential write — instead of rewriting the whole snapshot inside the
+// click handler. The snapshot is rewritten only at compaction points, and
+// recovery after a crash replays the journaled choices on top of the last
+// snapshot. Copyable for the same reason as SceneArchive: speculative
+// engine copies share the handle and never write through it.
+class SaveJournal
+{
+public:
+    explicit SaveJournal(const QString &savePath = QString());
+
+    QString journalPath() const { return m_journalPath; }
+
+    // Appends a choice record and flushes it; returns false if the journal
+    // cannot be written (callers fall back to a full snapshot save)
+    bool appendChoice(int choiceIndex);
+
+    // Choice indices recorded since the last compaction, in commit order
+    QList<int> replayChoices() const;
+
+    int recordCount() const { return m_recordCount; }
+
+    // Truncates the journal after the snapshot has absorbed its records
+    void clear();
+
+private:
+    bool ensureOpen();
+
+    QString m_journalPath;
+    QSharedPointer<QFile> m_file;
+    int m_recordCount;
+};
+
+#endif // SAVE_JOURNAL_H
@@ -0,0 +1,148 @@
+#include "scene_archive.h"
+
+#include <QtEndian>
+
+namespace {
+
+const char kMagic[4] = {'I', 'T', 'D', 'A'};
+const quint32 kVersion = 1;
+
+const quint32 kHeaderSize = 12;
+const quint32 kIndexEntrySize = 8;
+const quint32 kRecordFixedSize = 32;
+const quint32 kChoiceSize = 24;
+
+} // namespace
+
+SceneArchive::SceneArchive()
+    : m_data(nullptr)
+    , m_size(0)
+{
+}
+
+quint32 SceneArchive::readU32(quint32 offset) const
+{
+    return qFromLittleEndian<quint32>(m_data + offset);
+}
+
+qint32 SceneArchive::readI32(quint32 offset) const
+{
+    return qFromLittleEndian<qint32>(m_data + offset);
+}
+
+QString SceneArchive::readString(quint32 offset, quint32 length) const
+{
+    if (qint64(offset) + length > m_size) {
+        return QString();
+    }
+    return QString::fromUtf8(reinterpret_cast<const char *>(m_data + offset), int(length));
+}
+
+bool SceneArchive::load(const QString &path)
+{
+    QSharedPointer<QFile> file(new QFile(path));
+    if (!file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 size = file->size();
+    if (size < qint64(kHeaderSize)) {
+        return false;
+    }
+
+    const uchar *data = file->map(0, size);
+    if (!data) {
+        return false;
+    }
+
+    if (memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+
+    m_file = file;
+    m_data = data;
+    m_size = size;
+
+    if (readU32(4) != kVersion) {
+        m_data = nullptr;
+        return false;
+    }
+
+    quint32 sceneCount = readU32(8);
+    if (kHeaderSize + qint64(sceneCount) * kIndexEntrySize > m_size) {
+        m_data = nullptr;
+        return false;
+    }
+
+    m_index.clear();
+    m_index.reserve(int(sceneCount));
+    for (quint32 i = 0; i < sceneCount; ++i) {
+        quint32 entry = kHeaderSize + i * kIndexEntrySize;
+        m_index.insert(readI32(entry), readU32(entry + 4));
+    }
+
+    return true;
+}
+
+int SceneArchive::resolveTarget(int sceneId, int nextScene) const
+{
+    // Mirrors applyChoice: an explicit, existing target wins, otherwise the
+    // story follows the default progression to the next scene id
+    if (nextScene && m_index.contains(nextScene)) {
+        return nextScene;
+    }
+    return sceneId < sceneCount() ? sceneId + 1 : sceneId;
+}
+
+SceneData SceneArchive::sceneData(int sceneId) const
+{
+    SceneData scene;
+    scene.sceneId = 0;
+
+    auto it = m_index.constFind(sceneId);
+    if (!isLoaded() || it == m_index.constEnd()) {
+        return scene;
+    }
+
+    quint32 record = it.value();
+    scene.sceneId = readI32(record);
+    scene.background = readString(readU32(record + 4), readU32(record + 8));
+    scene.dialogue = readString(readU32(record + 12), readU32(record + 16));
+    scene.audioTrack = readString(readU32(record + 20), readU32(record + 24));
+
+    qint32 choiceCount = readI32(record + 28);
+    quint32 choiceOffset = record + kRecordFixedSize;
+    for (qint32 i = 0; i < choiceCount; ++i, choiceOffset += kChoiceSize) {
+        ChoiceData choice;
+        choice.text = readString(readU32(choiceOffset), readU32(choiceOffset + 4));
+        choice.memoryType = readString(readU32(choiceOffset + 8), readU32(choiceOffset + 12));
+        choice.nextScene = resolveTarget(sceneId, readI32(choiceOffset + 20));
+        scene.choices.append(choice);
+    }
+
+    return scene;
+}
+
+QList<ArchivedChoice> SceneArchive::choices(int sceneId) const
+{
+    QList<ArchivedChoice> result;
+
+    auto it = m_index.constFind(sceneId);
+    if (!isLoaded() || it == m_index.constEnd()) {
+        return result;
+    }
+
+    quint32 record = it.value();
+    qint32 choiceCount = readI32(record + 28);
+    quint32 choiceOffset = record + kRecordFixedSize;
+    for (qint32 i = 0; i < choiceCount; ++i, choiceOffset += kChoiceSize) {
+        ArchivedChoice choice;
+        choice.text = readString(readU32(choiceOffset), readU32(choiceOffset + 4));
+        choice.memoryType = readString(readU32(choiceOffset + 8), readU32(choiceOffset + 12));
+        choice.memoryValue = readI32(choiceOffset + 16);
+        choice.nextScene = readI32(choiceOffset + 20);
+        result.append(choice);
+    }
+
+    return result;
+}
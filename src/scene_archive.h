@@ -0,0 +1,53 @@
+#ifndef SCENE_ARCHIVE_H
+#define SCENE_ARCHIVE_H
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+
+#include "scene_data.h"
+
+// Choice record read from the binary scene archive, including the routing
+// metadata the engine needs to apply it
+struct ArchivedChoice {
+    QString text;
+    QString memoryType;
+    int memoryValue;
+    int nextScene; // 0 means default progression
+};
+
+// Memory-mapped reader for the binary scene archive produced at build time
+// by tools/compile_scenes.py. Scene lookup is an O(1) index hit followed by
+// direct offset reads into read-only mapped pages — no JSON, no parsing, and
+// load time independent of story size.
+//
+// Instances are cheap to copy: they share the mapping.
+class SceneArchive
+{
+public:
+    SceneArchive();
+
+    bool load(const QString &path);
+    bool isLoaded() const { return m_data != nullptr; }
+
+    int sceneCount() const { return m_index.size(); }
+    bool contains(int sceneId) const { return m_index.contains(sceneId); }
+
+    SceneData sceneData(int sceneId) const;
+    QList<ArchivedChoice> choices(int sceneId) const;
+
+private:
+    int resolveTarget(int sceneId, int nextScene) const;
+    QString readString(quint32 offset, quint32 length) const;
+    quint32 readU32(quint32 offset) const;
+    qint32 readI32(quint32 offset) const;
+
+    QSharedPointer<QFile> m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    QHash<int, quint32> m_index; // sceneId -> record offset
+};
+
+#endif // SCENE_ARCHIVE_H
@@ -0,0 +1,62 @@
+#ifndef SCENE_DATA_H
+#define SCENE_DATA_H
+
+#include <QList>
+#include <QMetaType>
+#include <QPair>
+#include <QString>
+
+// One selectable choice, with its target resolved by the engine so the
+// frontend never needs a round trip to learn where a choice leads
+// All payload members below are implicitly shared Qt types: copies are
+// refcount bumps, and the defaulted move operations steal the buffers
+// outright. The pipeline moves parsed payloads where ownership actually
+// transfers (parse loops, speculation handoff, history pops) so a click
+// never deep-copies scene text.
+struct ChoiceData {
+    QString text;
+    QString memoryType;
+    int nextScene; // resolved target scene id
+};
+
+// Scene payload shared by the native engine and the Python backend bridge
+struct SceneData {
+    int sceneId;
+    QString background;
+    QString dialogue;
+    QList<ChoiceData> choices;
+    QString audioTrack;
+};
+
+// Contiguous index of the whole scene graph: entry N holds the resolved
+// choice-target scene ids of scene N (entry 0 is unused padding, keeping
+// lookups a direct subscript)
+typedef QList<QList<int>> SceneGraphIndex;
+
+// Memory payload shared by the native engine and the Python backend bridge
+struct MemoryData {
+    double kindness;
+    double obsession;
+    double truth;
+    double trust;
+    QString alignment;
+
+    // Stats that changed since the previous delivered payload, filled in by
+    // the engine interface; everything is dirty by default so payloads that
+    // bypass the diff still repaint fully
+    enum DirtyFlag {
+        KindnessDirty = 0x01,
+        ObsessionDirty = 0x02,
+        TruthDirty = 0x04,
+        TrustDirty = 0x08,
+        AlignmentDirty = 0x10,
+        AllDirty = 0x1F
+    };
+    int dirty = AllDirty;
+};
+
+Q_DECLARE_METATYPE(SceneData)
+Q_DECLARE_METATYPE(MemoryData)
+Q_DECLARE_METATYPE(SceneGraphIndex)
+
+#endif // SCENE_DATA_H
@@ -0,0 +1,253 @@
+// Headless soak server for automated playthroughs.
+//
+// Drives N native engine sessions concurrently on the global thread pool
+// through scripted jobs, one JSON object per line, read from stdin or from a
+// local socket (--socket <name>). Each job answers with one JSON line of
+// per-scene latency percentiles and memory-model outcomes, so overnight runs
+// surface content-induced slow paths — huge dialogue blobs, pathological
+// scenes — before they hit a kiosk.
+//
+// Job format:    {"id": 1, "sessions": 8, "playthroughs": 100, "seed": 7}
+// Run it like:   IntoTheDarkServer < jobs.jsonl
+//           or:  IntoTheDarkServer --socket intothedark-soak
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QRandomGenerator>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstdio>
+
+#include "story_engine.h"
+
+namespace {
+
+// A playthrough that never reaches an ending is cut off rather than looping
+// forever on cyclic content
+const int kMaxScenesPerPlaythrough = 256;
+
+struct SessionReport {
+    // Advance latency samples per resulting scene id
+    QHash<int, QVector<qint64>> sceneNs;
+    QHash<int, int> dialogueBytes;
+    QHash<QString, int> alignments;
+    int playthroughs = 0;
+    int endings = 0;
+};
+
+double percentileUs(QVector<qint64> samplesNs, double fraction)
+{
+    if (samplesNs.isEmpty())
+        return 0.0;
+    std::sort(samplesNs.begin(), samplesNs.end());
+    int index = static_cast<int>(fraction * (samplesNs.size() - 1) + 0.5);
+    return samplesNs.at(index) / 1000.0;
+}
+
+// One session: a private engine instance playing `playthroughs` scripted
+// games with a deterministic per-session choice stream
+SessionReport runSession(int sessionIndex, int playthroughs, quint32 seed)
+{
+    SessionReport report;
+    StoryEngine engine(QString("save/soak_session_%1.json").arg(sessionIndex));
+    QRandomGenerator random(seed + quint32(sessionIndex));
+
+    QElapsedTimer timer;
+    for (int run = 0; run < playthroughs; ++run) {
+        engine.resetGame();
+        ++report.playthroughs;
+
+        SceneData scene = engine.currentScene();
+        for (int step = 0; step < kMaxScenesPerPlaythrough; ++step) {
+            if (scene.choices.isEmpty()) {
+                ++report.endings;
+                break;
+            }
+
+            const int choice = random.bounded(scene.choices.size());
+            MemoryData memory;
+            timer.start();
+            if (!engine.advance(choice, scene, memory)) {
+                break;
+            }
+            const qint64 elapsedNs = timer.nsecsElapsed();
+
+            report.sceneNs[scene.sceneId].append(elapsedNs);
+            report.dialogueBytes[scene.sceneId] =
+                qMax(report.dialogueBytes.value(scene.sceneId),
+                     int(scene.dialogue.toUtf8().size()));
+        }
+
+        report.alignments[engine.memoryData().alignment] += 1;
+    }
+
+    return report;
+}
+
+QJsonObject runJob(const QJsonObject &job)
+{
+    const int sessions = qBound(1, job["sessions"].toInt(1),
+                                QThread::idealThreadCount() * 4);
+    const int playthroughs = qMax(1, job["playthroughs"].toInt(1));
+    const quint32 seed = quint32(job["seed"].toInt(1));
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    QList<int> indices;
+    for (int i = 0; i < sessions; ++i)
+        indices.append(i);
+
+    // Sessions fan out over the global pool; the job is done when the
+    // slowest session finishes
+    const QList<SessionReport> reports = QtConcurrent::blockingMapped(
+        indices, [playthroughs, seed](int sessionIndex) {
+            return runSession(sessionIndex, playthroughs, seed);
+        });
+
+    // Merge per-session results
+    QHash<int, QVector<qint64>> sceneNs;
+    QHash<int, int> dialogueBytes;
+    QHash<QString, int> alignments;
+    QVector<qint64> allNs;
+    int totalPlaythroughs = 0;
+    int totalEndings = 0;
+
+    for (const SessionReport &report : reports) {
+        for (auto it = report.sceneNs.constBegin(); it != report.sceneNs.constEnd(); ++it) {
+            sceneNs[it.key()] += it.value();
+            allNs += it.value();
+        }
+        for (auto it = report.dialogueBytes.constBegin();
+             it != report.dialogueBytes.constEnd(); ++it) {
+            dialogueBytes[it.key()] = qMax(dialogueBytes.value(it.key()), it.value());
+        }
+        for (auto it = report.alignments.constBegin();
+             it != report.alignments.constEnd(); ++it) {
+            alignments[it.key()] += it.value();
+        }
+        totalPlaythroughs += report.playthroughs;
+        totalEndings += report.endings;
+    }
+
+    QJsonArray perScene;
+    QList<int> sceneIds = sceneNs.keys();
+    std::sort(sceneIds.begin(), sceneIds.end());
+    for (int sceneId : sceneIds) {
+        QJsonObject row;
+        row["scene_id"] = sceneId;
+        row["samples"] = sceneNs.value(sceneId).size();
+        row["p95_us"] = percentileUs(sceneNs.value(sceneId), 0.95);
+        row["dialogue_bytes"] = dialogueBytes.value(sceneId);
+        perScene.append(row);
+    }
+
+    QJsonObject outcomes;
+    for (auto it = alignments.constBegin(); it != alignments.constEnd(); ++it) {
+        outcomes[it.key()] = it.value();
+    }
+
+    QJsonObject result;
+    if (job.contains("id")) {
+        result["id"] = job["id"];
+    }
+    result["sessions"] = sessions;
+    result["playthroughs"] = totalPlaythroughs;
+    result["endings"] = totalEndings;
+    result["wall_ms"] = double(wallClock.elapsed());
+    result["advance_p50_us"] = percentileUs(allNs, 0.50);
+    result["advance_p95_us"] = percentileUs(allNs, 0.95);
+    result["advance_p99_us"] = percentileUs(allNs, 0.99);
+    result["scenes"] = perScene;
+    result["alignments"] = outcomes;
+    return result;
+}
+
+// Parses one job line and runs it; malformed lines answer with an error
+// object instead of killing the run
+QByteArray handleLine(const QByteArray &line)
+{
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+
+    QJsonObject result;
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        result["error"] = QString("parse error: %1").arg(parseError.errorString());
+    } else {
+        result = runJob(doc.object());
+    }
+
+    QByteArray out = QJsonDocument(result).toJson(QJsonDocument::Compact);
+    out.append('\n');
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const QStringList args = app.arguments();
+    const int socketIndex = args.indexOf("--socket");
+
+    if (socketIndex < 0) {
+        // stdin mode: run every job line, answer on stdout, exit at EOF
+        QFile input;
+        if (!input.open(stdin, QIODevice::ReadOnly)) {
+            std::fprintf(stderr, "cannot read stdin\n");
+            return 1;
+        }
+        while (!input.atEnd()) {
+            const QByteArray line = input.readLine().trimmed();
+            if (line.isEmpty())
+                continue;
+            const QByteArray out = handleLine(line);
+            std::fwrite(out.constData(), 1, size_t(out.size()), stdout);
+            std::fflush(stdout);
+        }
+        return 0;
+    }
+
+    const QString socketName = socketIndex + 1 < args.size()
+        ? args.at(socketIndex + 1)
+        : QString("intothedark-soak");
+
+    QLocalServer::removeServer(socketName);
+    QLocalServer server;
+    if (!server.listen(socketName)) {
+        std::fprintf(stderr, "cannot listen on %s: %s\n",
+                     qPrintable(socketName), qPrintable(server.errorString()));
+        return 1;
+    }
+    std::fprintf(stderr, "soak server listening on %s\n", qPrintable(socketName));
+
+    QObject::connect(&server, &QLocalServer::newConnection, [&server]() {
+        while (QLocalSocket *socket = server.nextPendingConnection()) {
+            QObject::connect(socket, &QLocalSocket::readyRead, [socket]() {
+                // Jobs run to completion before the next line is read; a
+                // soak rig wants back pressure, not queueing
+                while (socket->canReadLine()) {
+                    const QByteArray line = socket->readLine().trimmed();
+                    if (line.isEmpty())
+                        continue;
+                    socket->write(handleLine(line));
+                    socket->flush();
+                }
+            });
+            QObject::connect(socket, &QLocalSocket::disconnected,
+                             socket, &QObject::deleteLater);
+        }
+    });
+
+    return app.exec();
+}
@@ -0,0 +1,444 @@
+#include "story_engine.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+// Snapshot rewrites happen at most once per this many journaled choices
+const int kJournalCompactionThreshold = 32;
+}
+
+StoryEngine::StoryEngine(const QString &savePath)
+    : m_savePath(savePath)
+    , m_journal(savePath)
+    , m_currentScene(1)
+    , m_actProgression(1)
+{
+    loadScenes();
+    loadGameState();
+}
+
+QString StoryEngine::archivePath()
+{
+    if (QFile::exists("scenes.bin")) {
+        return "scenes.bin";
+    }
+    if (QCoreApplication::instance()) {
+        return QCoreApplication::applicationDirPath() + "/scenes.bin";
+    }
+    return QString();
+}
+
+void StoryEngine::loadScenes()
+{
+    // Prefer the memory-mapped archive compiled at build time; fall back to
+    // the built-in scene table when running from a tree without one
+    QString path = archivePath();
+    if (!path.isEmpty() && m_archive.load(path)) {
+        return;
+    }
+
+    // Scene 1 - The Awakening
+    Scene scene1;
+    scene1.sceneId = 1;
+    scene1.background = "cutscene1.jpg";
+    scene1.dialogue = "Rika wakes in the red-ash wasteland, surrounded by shattered ruins.\n\n"
+                      "Rika: \"This place again... the world that forgot how to die.\"";
+    scene1.choices = {
+        {"Call out for anyone.", "kindness", 5, 0},
+        {"Stay silent and listen.", "obsession", 5, 0},
+        {"Touch the mirror shard beside you.", "truth", 5, 0},
+        {"Scan the surroundings carefully.", "trust", 5, 0}
+    };
+    scene1.audioTrack = "audio1.mp3";
+    m_scenes[1] = scene1;
+
+    // Scene 2 - Echoes of the Machine
+    Scene scene2;
+    scene2.sceneId = 2;
+    scene2.background = "cutscene2.jpg";
+    scene2.dialogue = "Rika approaches flickering terminals whispering fragments of her name.";
+    scene2.choices = {
+        {"Speak to the terminals.", "kindness", 5, 0},
+        {"Ignore them and focus on her path.", "obsession", 5, 0},
+        {"Try to decode the messages.", "truth", 5, 0},
+        {"Call for Penci to help.", "trust", 5, 0}
+    };
+    scene2.audioTrack = "audio2.mp3";
+    m_scenes[2] = scene2;
+
+    // Scene 3 - The Companion Appears
+    Scene scene3;
+    scene3.sceneId = 3;
+    scene3.background = "cutscene3.jpg";
+    scene3.dialogue = "Penci Zorno emerges from the ruins carrying a broken lantern.\n\n"
+                      "Penci: \"Rika… I thought I lost you again.\"\n\n"
+                      "Rika: \"Then let's move together.\"";
+    scene3.choices = {
+        {"Move cautiously together.", "trust", 5, 0},
+        {"Lead the way alone.", "obsession", 5, 0},
+        {"Talk to Penci about the ruins.", "kindness", 5, 0},
+        {"Examine the ruins first.", "truth", 5, 0}
+    };
+    scene3.audioTrack = "audio3.mp3";
+    m_scenes[3] = scene3;
+
+    // Scene 4 - The Mirror of Memory
+    Scene scene4;
+    scene4.sceneId = 4;
+    scene4.background = "cutscene4.jpg";
+    scene4.dialogue = "Rika sees her reflection in a cracked mirror, distorted by light.";
+    scene4.choices = {
+        {"Touch the reflection.", "truth", 5, 0},
+        {"Step back and observe.", "obsession", 5, 0},
+        {"Speak to it gently.", "kindness", 5, 0},
+        {"Ignore and move forward.", "trust", 5, 0}
+    };
+    scene4.audioTrack = "audio4.mp3";
+    m_scenes[4] = scene4;
+
+    // Placeholder scenes 5-10
+    for (int i = 5; i <= 10; ++i) {
+        Scene scene;
+        scene.sceneId = i;
+        scene.background = QString("cutscene%1.jpg").arg(i);
+        scene.dialogue = QString("Scene %1 - Placeholder dialogue for future development.").arg(i);
+        scene.choices = {
+            {QString("Choice 1 for scene %1").arg(i), "kindness", 5, 0},
+            {QString("Choice 2 for scene %1").arg(i), "obsession", 5, 0},
+            {QString("Choice 3 for scene %1").arg(i), "truth", 5, 0},
+            {QString("Choice 4 for scene %1").arg(i), "trust", 5, 0}
+        };
+        scene.audioTrack = "audio1.mp3"; // Reuse audio tracks
+        m_scenes[i] = scene;
+    }
+}
+
+void StoryEngine::loadGameState()
+{
+    m_currentScene = 1;
+    m_watchedCutscenes.clear();
+    m_memoryValues = {{"kindness", 0}, {"obsession", 0}, {"truth", 0}, {"trust", 0}};
+    m_actProgression = 1;
+
+    // Load the last snapshot when a readable one exists; a fresh install or
+    // an unparseable file starts from the defaults above
+    QFile saveFile(m_savePath);
+    if (saveFile.exists() && saveFile.open(QIODevice::ReadOnly)) {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(saveFile.readAll(), &parseError);
+        if (parseError.error == QJsonParseError::NoError && doc.isObject()) {
+            QJsonObject state = doc.object();
+            m_currentScene = state["current_scene"].toInt(1);
+            if (!sceneExists(m_currentScene)) {
+                m_currentScene = 1;
+            }
+
+            for (const QJsonValue &value : state["watched_cutscenes"].toArray()) {
+                m_watchedCutscenes.append(value.toInt());
+            }
+
+            QJsonObject memoryValues = state["memory_values"].toObject();
+            for (auto it = m_memoryValues.begin(); it != m_memoryValues.end(); ++it) {
+                it.value() = memoryValues[it.key()].toInt(0);
+            }
+
+            m_actProgression = state["act_progression"].toInt(1);
+        }
+    }
+
+    // Crash recovery: replay choices journaled since the last snapshot,
+    // then fold them into a fresh snapshot and truncate the journal. This
+    // runs with or without a snapshot — before the first compaction the
+    // journal is the only persisted progress, replayed on top of the
+    // defaults above.
+    const QList<int> journaled = m_journal.replayChoices();
+    if (!journaled.isEmpty()) {
+        for (int choiceIndex : journaled) {
+            applyChoice(choiceIndex);
+        }
+        saveGameState();
+        m_journal.clear();
+    }
+}
+
+bool StoryEngine::saveGameState() const
+{
+    QDir().mkpath(QFileInfo(m_savePath).path());
+
+    QJsonObject state;
+    state["current_scene"] = m_currentScene;
+
+    QJsonArray watched;
+    for (int sceneId : m_watchedCutscenes) {
+        watched.append(sceneId);
+    }
+    state["watched_cutscenes"] = watched;
+
+    QJsonObject memoryValues;
+    for (auto it = m_memoryValues.constBegin(); it != m_memoryValues.constEnd(); ++it) {
+        memoryValues[it.key()] = it.value();
+    }
+    state["memory_values"] = memoryValues;
+    state["act_progression"] = m_actProgression;
+
+    QFile saveFile(m_savePath);
+    if (!saveFile.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    saveFile.write(QJsonDocument(state).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+bool StoryEngine::sceneExists(int sceneId) const
+{
+    return m_archive.isLoaded() ? m_archive.contains(sceneId) : m_scenes.contains(sceneId);
+}
+
+int StoryEngine::sceneCount() const
+{
+    return m_archive.isLoaded() ? m_archive.sceneCount() : m_scenes.size();
+}
+
+SceneData StoryEngine::currentScene() const
+{
+    if (m_archive.isLoaded()) {
+        // Direct offset reads into the mapped archive — nothing to parse
+        return m_archive.sceneData(m_currentScene);
+    }
+
+    SceneData data;
+    const Scene scene = m_scenes.value(m_currentScene);
+
+    data.sceneId = scene.sceneId;
+    data.background = scene.background;
+    data.dialogue = scene.dialogue;
+    data.audioTrack = scene.audioTrack;
+    for (const Choice &choice : scene.choices) {
+        ChoiceData choiceData;
+        choiceData.text = choice.text;
+        choiceData.memoryType = choice.memoryType;
+        choiceData.nextScene = resolveTarget(scene.sceneId, choice.nextScene);
+        data.choices.append(choiceData);
+    }
+
+    return data;
+}
+
+QList<int> StoryEngine::stateDependentScenes() const
+{
+    // Scene content is currently deterministic per scene id; scenes whose
+    // dialogue or choices come to depend on memory state must be declared
+    // here so the frontend response cache keys them by state hash
+    return QList<int>();
+}
+
+int StoryEngine::resolveTarget(int sceneId, int nextScene) const
+{
+    // Mirrors applyChoice: an explicit, existing target wins, otherwise the
+    // story follows the default progression to the next scene id
+    if (nextScene && sceneExists(nextScene)) {
+        return nextScene;
+    }
+    return sceneId < sceneCount() ? sceneId + 1 : sceneId;
+}
+
+SceneGraphIndex StoryEngine::sceneGraph() const
+{
+    // Scene ids are contiguous from 1, so the index is a direct subscript
+    SceneGraphIndex graph(sceneCount() + 1);
+    for (int sceneId = 1; sceneId <= sceneCount(); ++sceneId) {
+        QList<int> targets;
+        if (m_archive.isLoaded()) {
+            const QList<ArchivedChoice> choices = m_archive.choices(sceneId);
+            for (const ArchivedChoice &choice : choices) {
+                targets.append(resolveTarget(sceneId, choice.nextScene));
+            }
+        } else {
+            const Scene scene = m_scenes.value(sceneId);
+            for (const Choice &choice : scene.choices) {
+                targets.append(resolveTarget(sceneId, choice.nextScene));
+            }
+        }
+        graph[sceneId] = targets;
+    }
+    return graph;
+}
+
+double StoryEngine::memoryPercentage(const QString &memoryType) const
+{
+    // Memory values cap at 100, matching the Python engine's percentages
+    return qMin(double(m_memoryValues.value(memoryType, 0)), 100.0);
+}
+
+QString StoryEngine::memoryAlignment() const
+{
+    QString dominantType;
+    double dominantValue = -1.0;
+    for (auto it = m_memoryValues.constBegin(); it != m_memoryValues.constEnd(); ++it) {
+        double value = memoryPercentage(it.key());
+        if (value > dominantValue) {
+            dominantValue = value;
+            dominantType = it.key();
+        }
+    }
+
+    if (dominantValue < 20.0) {
+        return "Neutral";
+    } else if (dominantType == "kindness") {
+        return "Kind";
+    } else if (dominantType == "obsession") {
+        return "Obsessed";
+    } else if (dominantType == "truth") {
+        return "Truth-Seeker";
+    } else if (dominantType == "trust") {
+        return "Trusting";
+    }
+
+    return "Balanced";
+}
+
+MemoryData StoryEngine::memoryData() const
+{
+    MemoryData data;
+    data.kindness = memoryPercentage("kindness");
+    data.obsession = memoryPercentage("obsession");
+    data.truth = memoryPercentage("truth");
+    data.trust = memoryPercentage("trust");
+    data.alignment = memoryAlignment();
+    return data;
+}
+
+bool StoryEngine::applyChoice(int choiceIndex)
+{
+    QString memoryType;
+    int memoryValue = 0;
+    int nextScene = 0;
+
+    if (m_archive.isLoaded()) {
+        QList<ArchivedChoice> choices = m_archive.choices(m_currentScene);
+        if (choiceIndex < 0 || choiceIndex >= choices.size()) {
+            return false;
+        }
+        memoryType = choices[choiceIndex].memoryType;
+        memoryValue = choices[choiceIndex].memoryValue;
+        nextScene = choices[choiceIndex].nextScene;
+    } else {
+        const Scene &scene = m_scenes[m_currentScene];
+        if (choiceIndex < 0 || choiceIndex >= scene.choices.size()) {
+            return false;
+        }
+        const Choice &choice = scene.choices[choiceIndex];
+        memoryType = choice.memoryType;
+        memoryValue = choice.memoryValue;
+        nextScene = choice.nextScene;
+    }
+
+    m_memoryValues[memoryType] += memoryValue;
+
+    if (!m_watchedCutscenes.contains(m_currentScene)) {
+        m_watchedCutscenes.append(m_currentScene);
+    }
+
+    if (nextScene && sceneExists(nextScene)) {
+        m_currentScene = nextScene;
+    } else if (m_currentScene < sceneCount()) {
+        // Default progression
+        m_currentScene += 1;
+    }
+
+    return true;
+}
+
+bool StoryEngine::makeChoice(int choiceIndex)
+{
+    if (!applyChoice(choiceIndex)) {
+        return false;
+    }
+
+    // Persistence is a few dozen bytes of sequential append; the snapshot
+    // is only rewritten at compaction points, never inside the choice path
+    if (!m_journal.appendChoice(choiceIndex)) {
+        return saveGameState();
+    }
+
+    if (m_journal.recordCount() >= kJournalCompactionThreshold) {
+        if (saveGameState()) {
+            m_journal.clear();
+        }
+    }
+    return true;
+}
+
+bool StoryEngine::compactJournal()
+{
+    // Folds journaled choices into the snapshot; called at clean shutdown
+    // so the next launch starts from the snapshot instead of relying on
+    // crash recovery
+    if (m_journal.recordCount() == 0) {
+        return true;
+    }
+    if (!saveGameState()) {
+        return false;
+    }
+    m_journal.clear();
+    return true;
+}
+
+bool StoryEngine::advance(int choiceIndex, SceneData &scene, MemoryData &memory)
+{
+    if (!makeChoice(choiceIndex)) {
+        return false;
+    }
+
+    scene = currentScene();
+    memory = memoryData();
+    return true;
+}
+
+bool StoryEngine::peekAdvance(int choiceIndex, SceneData &scene, MemoryData &memory) const
+{
+    // Evaluate the choice on a throwaway copy; the containers are implicitly
+    // shared, so the copy costs a few refcounts rather than a deep clone
+    StoryEngine speculative(*this);
+    if (!speculative.applyChoice(choiceIndex)) {
+        return false;
+    }
+
+    scene = speculative.currentScene();
+    memory = speculative.memoryData();
+    return true;
+}
+
+bool StoryEngine::restoreState(int sceneId, const MemoryData &memory)
+{
+    if (!sceneExists(sceneId)) {
+        return false;
+    }
+
+    m_currentScene = sceneId;
+    m_memoryValues["kindness"] = int(memory.kindness);
+    m_memoryValues["obsession"] = int(memory.obsession);
+    m_memoryValues["truth"] = int(memory.truth);
+    m_memoryValues["trust"] = int(memory.trust);
+
+    // The restored state supersedes everything journaled after it
+    m_journal.clear();
+    return saveGameState();
+}
+
+bool StoryEngine::resetGame()
+{
+    m_currentScene = 1;
+    m_watchedCutscenes.clear();
+    m_memoryValues = {{"kindness", 0}, {"obsession", 0}, {"truth", 0}, {"trust", 0}};
+    m_actProgression = 1;
+    m_journal.clear();
+    return saveGameState();
+}
@@ -0,0 +1,71 @@
+#ifndef STORY_ENGINE_H
+#define STORY_ENGINE_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include "save_journal.h"
+#include "scene_archive.h"
+#include "scene_data.h"
+
+// Native story engine core.
+//
+// Mirrors python_backend/story_engine.py: it owns the scene graph, applies
+// choice effects to the kindness/obsession/truth/trust memory model, and
+// persists game state to the same save/save.json format, so the Python
+// engine remains usable as a drop-in compatibility backend.
+class StoryEngine
+{
+public:
+    explicit StoryEngine(const QString &savePath = QString("save/save.json"));
+
+    SceneData currentScene() const;
+    MemoryData memoryData() const;
+    SceneGraphIndex sceneGraph() const;
+    QList<int> stateDependentScenes() const;
+    bool makeChoice(int choiceIndex);
+    bool compactJournal();
+    bool advance(int choiceIndex, SceneData &scene, MemoryData &memory);
+    bool peekAdvance(int choiceIndex, SceneData &scene, MemoryData &memory) const;
+    bool restoreState(int sceneId, const MemoryData &memory);
+    bool resetGame();
+
+private:
+    struct Choice {
+        QString text;
+        QString memoryType;
+        int memoryValue;
+        int nextScene; // 0 means default progression to the next scene
+    };
+
+    struct Scene {
+        int sceneId;
+        QString background;
+        QString dialogue;
+        QList<Choice> choices;
+        QString audioTrack;
+    };
+
+    void loadScenes();
+    bool applyChoice(int choiceIndex);
+    void loadGameState();
+    bool saveGameState() const;
+    bool sceneExists(int sceneId) const;
+    int sceneCount() const;
+    int resolveTarget(int sceneId, int nextScene) const;
+    double memoryPercentage(const QString &memoryType) const;
+    QString memoryAlignment() const;
+    static QString archivePath();
+
+    QString m_savePath;
+    SaveJournal m_journal;
+    SceneArchive m_archive;
+    QMap<int, Scene> m_scenes;
+    int m_currentScene;
+    QList<int> m_watchedCutscenes;
+    QMap<QString, int> m_memoryValues;
+    int m_actProgression;
+};
+
+#endif // STORY_ENGINE_H
@@ -0,0 +1,115 @@
+#include "styled_widgets.h"
+
+#include <QPainter>
+
+StyledButton::Colors StyledButton::choiceColors()
+{
+    Colors colors;
+    colors.base = QColor(0x44, 0x44, 0x44);
+    colors.hover = QColor(0x55, 0x55, 0x55);
+    colors.pressed = QColor(0x33, 0x33, 0x33);
+    colors.border = QColor(0x66, 0x66, 0x66);
+    colors.borderHover = QColor(0x88, 0x88, 0x88);
+    colors.text = QColor(0xE0, 0xE0, 0xE0);
+    return colors;
+}
+
+StyledButton::Colors StyledButton::resetColors()
+{
+    Colors colors;
+    colors.base = QColor(0x66, 0x66, 0x66);
+    colors.hover = QColor(0x77, 0x77, 0x77);
+    colors.pressed = QColor(0x55, 0x55, 0x55);
+    colors.border = QColor(0x88, 0x88, 0x88);
+    colors.borderHover = QColor(0x88, 0x88, 0x88);
+    colors.text = QColor(0xE0, 0xE0, 0xE0);
+    return colors;
+}
+
+StyledButton::StyledButton(const Colors &colors, QWidget *parent)
+    : QPushButton(parent)
+    , m_colors(colors)
+{
+    setAttribute(Qt::WA_Hover);
+}
+
+void StyledButton::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const bool hovered = underMouse() && isEnabled();
+    QColor fill = m_colors.base;
+    if (isDown()) {
+        fill = m_colors.pressed;
+    } else if (hovered) {
+        fill = m_colors.hover;
+    }
+
+    painter.setPen(QPen(hovered ? m_colors.borderHover : m_colors.border, 1));
+    painter.setBrush(fill);
+    painter.drawRoundedRect(rect().adjusted(0, 0, -1, -1), 5, 5);
+
+    QColor textColor = m_colors.text;
+    if (!isEnabled()) {
+        textColor.setAlpha(120);
+    }
+    painter.setPen(textColor);
+    painter.drawText(rect().adjusted(10, 5, -10, -5),
+                     Qt::AlignCenter | Qt::TextWordWrap, text());
+}
+
+MemoryGauge::MemoryGauge(const QColor &chunkColor, QWidget *parent)
+    : QWidget(parent)
+    , m_chunkColor(chunkColor)
+    , m_value(0)
+    , m_target(0)
+{
+    setMinimumHeight(20);
+}
+
+void MemoryGauge::setValue(int value)
+{
+    value = qBound(0, value, 100);
+    m_target = value;
+    if (value == m_value) {
+        return;
+    }
+    m_value = value;
+    update();
+}
+
+void MemoryGauge::animateTo(int target)
+{
+    m_target = qBound(0, target, 100);
+}
+
+bool MemoryGauge::stepTowardTarget()
+{
+    if (m_value == m_target) {
+        return false;
+    }
+    m_value += (m_target > m_value) ? 1 : -1;
+    update();
+    return m_value != m_target;
+}
+
+void MemoryGauge::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    painter.setPen(QPen(QColor(0x66, 0x66, 0x66), 1));
+    painter.setBrush(QColor(0x33, 0x33, 0x33));
+    painter.drawRoundedRect(rect().adjusted(0, 0, -1, -1), 3, 3);
+
+    if (m_value > 0) {
+        const int chunkWidth = (width() - 2) * m_value / 100;
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(m_chunkColor);
+        painter.drawRoundedRect(QRect(1, 1, chunkWidth, height() - 2), 2, 2);
+    }
+
+    painter.setPen(QColor(0xE0, 0xE0, 0xE0));
+    painter.drawText(rect(), Qt::AlignCenter, QString("%1%").arg(m_value));
+}
@@ -0,0 +1,63 @@
+#ifndef STYLED_WIDGETS_H
+#define STYLED_WIDGETS_H
+
+#include <QColor>
+#include <QPushButton>
+#include <QWidget>
+
+// Custom-painted replacements for the stylesheet-driven controls. Colors are
+// resolved once at construction, so hover/press repaints are a direct fill
+// instead of a QSS re-parse and style cascade.
+
+class StyledButton : public QPushButton
+{
+    Q_OBJECT
+
+public:
+    struct Colors {
+        QColor base;
+        QColor hover;
+        QColor pressed;
+        QColor border;
+        QColor borderHover;
+        QColor text;
+    };
+
+    // The two looks used in the main window
+    static Colors choiceColors();
+    static Colors resetColors();
+
+    StyledButton(const Colors &colors, QWidget *parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    Colors m_colors;
+};
+
+// Fixed-color progress gauge for one memory stat
+class MemoryGauge : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryGauge(const QColor &chunkColor, QWidget *parent = nullptr);
+
+    void setValue(int value);
+
+    // Shared-timer animation: animateTo sets the destination, and the owner
+    // calls stepTowardTarget per tick until it returns false
+    void animateTo(int target);
+    bool stepTowardTarget();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QColor m_chunkColor;
+    int m_value;
+    int m_target;
+};
+
+#endif // STYLED_WIDGETS_H
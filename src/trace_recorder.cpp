@@ -0,0 +1,86 @@
+#include "trace_recorder.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+TraceRecorder *TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return &recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : m_next(0)
+{
+    for (Event &event : m_events) {
+        event.name = nullptr;
+    }
+    m_clock.start();
+}
+
+void TraceRecorder::record(const char *name, qint64 startNs, qint64 durationNs)
+{
+    // Claim a slot with one atomic increment; concurrent writers never
+    // contend on the same entry. A torn read during export can at worst
+    // garble one event out of 4096, which is acceptable for a crash dump.
+    const quint64 slot = m_next.fetch_add(1, std::memory_order_relaxed);
+    Event &event = m_events[slot % kCapacity];
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    event.threadId = reinterpret_cast<quint64>(QThread::currentThreadId());
+    event.phase = 'X';
+    event.name = name;
+}
+
+void TraceRecorder::counter(const char *name, qint64 value)
+{
+    const quint64 slot = m_next.fetch_add(1, std::memory_order_relaxed);
+    Event &event = m_events[slot % kCapacity];
+    event.startNs = nowNs();
+    event.durationNs = value;
+    event.threadId = reinterpret_cast<quint64>(QThread::currentThreadId());
+    event.phase = 'C';
+    event.name = name;
+}
+
+bool TraceRecorder::exportChromeTrace(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    const quint64 next = m_next.load(std::memory_order_relaxed);
+    const quint64 first = next > kCapacity ? next - kCapacity : 0;
+
+    QJsonArray traceEvents;
+    for (quint64 i = first; i < next; ++i) {
+        const Event &event = m_events[i % kCapacity];
+        if (!event.name) {
+            continue;
+        }
+        QJsonObject entry;
+        entry["name"] = QString::fromLatin1(event.name);
+        entry["ts"] = event.startNs / 1000.0;   // Chrome trace wants microseconds
+        entry["pid"] = 1;
+        entry["tid"] = double(event.threadId & 0xFFFFFF);
+        if (event.phase == 'C') {
+            entry["ph"] = "C";
+            QJsonObject args;
+            args["value"] = double(event.durationNs);
+            entry["args"] = args;
+        } else {
+            entry["ph"] = "X";
+            entry["dur"] = event.durationNs / 1000.0;
+        }
+        traceEvents.append(entry);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
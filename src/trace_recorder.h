@@ -0,0 +1,72 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+// Always-on flight recorder for the hot paths. Spans are written into a
+// fixed-size lock-free ring — one atomic increment plus four stores, no
+// allocation, no locks — and the most recent events can be dumped as a
+// Chrome-trace JSON file (chrome://tracing / Perfetto) after the fact.
+// Span names must be string literals; the ring stores only the pointer.
+class TraceRecorder
+{
+public:
+    static TraceRecorder *instance();
+
+    // Nanoseconds since recorder start, from a shared monotonic clock
+    qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+
+    void record(const char *name, qint64 startNs, qint64 durationNs);
+
+    // Counter track: samples a named value (e.g. bytes resident) so it can
+    // be plotted over time next to the spans
+    void counter(const char *name, qint64 value);
+
+    // Writes the ring contents, oldest first, in Chrome-trace format
+    bool exportChromeTrace(const QString &path) const;
+
+private:
+    TraceRecorder();
+
+    struct Event {
+        const char *name;
+        qint64 startNs;
+        qint64 durationNs; // counter events carry the sampled value here
+        quint64 threadId;
+        char phase;        // 'X' span, 'C' counter
+    };
+
+    static const int kCapacity = 4096; // power of two, ~128KB of events
+
+    Event m_events[kCapacity];
+    std::atomic<quint64> m_next;
+    QElapsedTimer m_clock;
+};
+
+// RAII span: times the enclosing scope and records it on destruction
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name)
+        : m_name(name)
+        , m_startNs(TraceRecorder::instance()->nowNs())
+    {
+    }
+
+    ~TraceSpan()
+    {
+        TraceRecorder *recorder = TraceRecorder::instance();
+        m_durationNs = recorder->nowNs() - m_startNs;
+        recorder->record(m_name, m_startNs, m_durationNs);
+    }
+
+private:
+    const char *m_name;
+    qint64 m_startNs;
+    qint64 m_durationNs;
+};
+
+#endif // TRACE_RECORDER_H
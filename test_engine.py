@@ -93,6 +93,193 @@ def test_cli_interface():
         print(f"✗ CLI Interface: FAILED - {e}\n")
         return False
 
+def test_serve_protocol():
+    """Test the persistent worker mode of the story engine"""
+    print("Testing Serve Protocol...")
+    try:
+        import subprocess
+
+        process = subprocess.Popen([
+            "python3", "python_backend/story_engine.py", "serve"
+        ], stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True,
+           cwd=Path(__file__).parent)
+
+        try:
+            # Start from a known state regardless of any existing save
+            process.stdin.write(json.dumps({"id": 0, "cmd": "reset_game"}) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["success"] == True
+
+            # Test get_scene request
+            process.stdin.write(json.dumps({"id": 1, "cmd": "get_scene"}) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["id"] == 1
+            assert "scene_id" in response
+            assert all("next_scene" in choice for choice in response["choices"])
+            print("✓ get_scene request works")
+
+            # Test get_scene_graph request
+            process.stdin.write(json.dumps({"id": 10, "cmd": "get_scene_graph"}) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["id"] == 10
+            assert len(response["scenes"]) == 10
+            assert response["scenes"][0] == [2, 2, 2, 2]
+            assert response["scenes"][-1] == [10, 10, 10, 10]
+            print("✓ get_scene_graph request works")
+
+            # Test get_memory request
+            process.stdin.write(json.dumps({"id": 2, "cmd": "get_memory"}) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["id"] == 2
+            assert "kindness" in response
+            print("✓ get_memory request works")
+
+            # Test restore_state request (rewind support)
+            process.stdin.write(json.dumps({
+                "id": 11, "cmd": "restore_state", "scene_id": 2,
+                "memory_values": {"kindness": 5}
+            }) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["success"] == True
+            process.stdin.write(json.dumps({"id": 12, "cmd": "get_scene"}) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["scene_id"] == 2
+            process.stdin.write(json.dumps({
+                "id": 13, "cmd": "restore_state", "scene_id": 1,
+                "memory_values": {"kindness": 0}
+            }) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["success"] == True
+            print("✓ restore_state request works")
+
+            # Test make_choice request
+            process.stdin.write(json.dumps({"id": 3, "cmd": "make_choice", "choice_index": 0}) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["id"] == 3
+            assert response["success"] == True
+            print("✓ make_choice request works")
+
+            # Test batched advance request
+            process.stdin.write(json.dumps({"id": 10, "cmd": "advance", "choice_index": 1}) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert response["success"] == True
+            assert "scene_id" in response["scene"]
+            assert "alignment" in response["memory"]
+            print("✓ advance request works")
+
+            # Test speculative peek request (must not advance the game state)
+            process.stdin.write(json.dumps({"id": 11, "cmd": "get_scene"}) + "\n")
+            process.stdin.flush()
+            before = json.loads(process.stdout.readline())
+            process.stdin.write(json.dumps({"id": 12, "cmd": "peek_choice", "choice_index": 0}) + "\n")
+            process.stdin.flush()
+            peeked = json.loads(process.stdout.readline())
+            assert peeked["success"] == True
+            assert peeked["scene"]["scene_id"] != before["scene_id"]
+            process.stdin.write(json.dumps({"id": 13, "cmd": "get_scene"}) + "\n")
+            process.stdin.flush()
+            after = json.loads(process.stdout.readline())
+            assert after["scene_id"] == before["scene_id"]
+            print("✓ peek_choice request works")
+
+            # Test shared-memory payload channel
+            import struct
+            import tempfile
+            with tempfile.NamedTemporaryFile(delete=False) as shm_file:
+                shm_file.write(b"\x00" * 65536)
+                shm_path = shm_file.name
+            try:
+                process.stdin.write(json.dumps({"id": 20, "cmd": "shm_init", "path": shm_path}) + "\n")
+                process.stdin.flush()
+                response = json.loads(process.stdout.readline())
+                assert response["success"] == True
+                process.stdin.write(json.dumps({"id": 21, "cmd": "get_scene"}) + "\n")
+                process.stdin.flush()
+                response = json.loads(process.stdout.readline())
+                offset, length = response["shm_scene"]
+                shm_data = open(shm_path, "rb").read()
+                scene_id = struct.unpack_from("<i", shm_data, offset)[0]
+                bg_len = struct.unpack_from("<I", shm_data, offset + 4)[0]
+                background = shm_data[offset + 20:offset + 20 + bg_len].decode("utf-8")
+                assert background == f"cutscene{scene_id}.jpg"
+                print("✓ Shared-memory payload channel works")
+            finally:
+                os.unlink(shm_path)
+
+            # Test unknown command error
+            process.stdin.write(json.dumps({"id": 4, "cmd": "bogus"}) + "\n")
+            process.stdin.flush()
+            response = json.loads(process.stdout.readline())
+            assert "error" in response
+            print("✓ Unknown command reporting works")
+
+            # Test clean shutdown
+            process.stdin.write(json.dumps({"id": 5, "cmd": "quit"}) + "\n")
+            process.stdin.flush()
+            process.wait(timeout=5)
+            assert process.returncode == 0
+            print("✓ Clean shutdown works")
+        finally:
+            if process.poll() is None:
+                process.kill()
+
+        print("✓ Serve Protocol: ALL TESTS PASSED\n")
+        return True
+
+    except Exception as e:
+        print(f"✗ Serve Protocol: FAILED - {e}\n")
+        return False
+
+def test_scene_archive():
+    """Test the binary scene archive compiler"""
+    print("Testing Scene Archive...")
+    try:
+        import struct
+        import tempfile
+
+        sys.path.insert(0, str(Path(__file__).parent / "tools"))
+        from compile_scenes import compile_archive, MAGIC, VERSION, HEADER_SIZE, INDEX_ENTRY_SIZE
+        from story_engine import StoryEngine
+
+        with tempfile.TemporaryDirectory() as tmp:
+            archive_path = os.path.join(tmp, "scenes.bin")
+            count = compile_archive(archive_path)
+            data = open(archive_path, "rb").read()
+
+        scenes = StoryEngine().scenes
+        assert count == len(scenes)
+        assert data[:4] == MAGIC
+        version, scene_count = struct.unpack_from("<II", data, 4)
+        assert version == VERSION
+        assert scene_count == len(scenes)
+        print("✓ Archive header is valid")
+
+        # Spot-check the first indexed record against the live engine
+        scene_id, record_offset = struct.unpack_from("<iI", data, HEADER_SIZE)
+        scene = scenes[scene_id]
+        assert struct.unpack_from("<i", data, record_offset)[0] == scene.scene_id
+        bg_off, bg_len = struct.unpack_from("<II", data, record_offset + 4)
+        assert data[bg_off:bg_off + bg_len].decode("utf-8") == scene.background
+        choice_count = struct.unpack_from("<i", data, record_offset + 28)[0]
+        assert choice_count == len(scene.choices)
+        print("✓ Scene records match the story definition")
+
+        print("✓ Scene Archive: ALL TESTS PASSED\n")
+        return True
+
+    except Exception as e:
+        print(f"✗ Scene Archive: FAILED - {e}\n")
+        return False
+
 def test_config_system():
     """Test the configuration system"""
     print("Testing Configuration System...")
@@ -245,6 +432,8 @@ def main():
     tests = [
         test_game_engine,
         test_cli_interface,
+        test_serve_protocol,
+        test_scene_archive,
         test_config_system,
         test_audio_system,
         test_transition_manager,
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""
+Into the Dark - Scene Archive Compiler
+Compiles the story definition into a flat, offset-indexed binary archive
+that the C++ frontend memory-maps for zero-parse scene lookup.
+
+Archive layout (all integers little-endian):
+    header:  magic b'ITDA', uint32 version, uint32 scene_count
+    index:   scene_count * (int32 scene_id, uint32 record_offset)
+    records: per scene, fixed-layout fields where every string is a
+             (uint32 offset, uint32 length) reference into the blob
+    blob:    deduplicated UTF-8 string data
+
+Record layout:
+    int32  scene_id
+    uint32 background_offset, background_length
+    uint32 dialogue_offset, dialogue_length
+    uint32 audio_offset, audio_length
+    int32  choice_count
+    choice_count * (uint32 text_offset, uint32 text_length,
+                    uint32 memory_type_offset, uint32 memory_type_length,
+                    int32 memory_value, int32 next_scene)
+"""
+
+import struct
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "python_backend"))
+
+from story_engine import StoryEngine
+
+MAGIC = b"ITDA"
+VERSION = 1
+
+HEADER_SIZE = 12
+INDEX_ENTRY_SIZE = 8
+RECORD_FIXED_SIZE = 32
+CHOICE_SIZE = 24
+
+
+def compile_archive(output_path: str) -> int:
+    scenes = StoryEngine().scenes
+    scene_ids = sorted(scenes.keys())
+
+    # Lay the file out up front so string references can be absolute offsets
+    records_offset = HEADER_SIZE + INDEX_ENTRY_SIZE * len(scene_ids)
+    record_offsets = {}
+    offset = records_offset
+    for scene_id in scene_ids:
+        record_offsets[scene_id] = offset
+        offset += RECORD_FIXED_SIZE + CHOICE_SIZE * len(scenes[scene_id].choices)
+    blob_offset = offset
+
+    blob = bytearray()
+    interned = {}
+
+    def intern(text) -> tuple:
+        data = (text or "").encode("utf-8")
+        if data not in interned:
+            interned[data] = blob_offset + len(blob)
+            blob.extend(data)
+        return interned[data], len(data)
+
+    out = bytearray()
+    out += MAGIC
+    out += struct.pack("<II", VERSION, len(scene_ids))
+
+    for scene_id in scene_ids:
+        out += struct.pack("<iI", scene_id, record_offsets[scene_id])
+
+    for scene_id in scene_ids:
+        scene = scenes[scene_id]
+        out += struct.pack("<i", scene.scene_id)
+        out += struct.pack("<II", *intern(scene.background))
+        out += struct.pack("<II", *intern(scene.dialogue))
+        out += struct.pack("<II", *intern(scene.audio_track))
+        out += struct.pack("<i", len(scene.choices))
+        for choice in scene.choices:
+            out += struct.pack("<II", *intern(choice.text))
+            out += struct.pack("<II", *intern(choice.memory_type.value))
+            out += struct.pack("<ii", choice.memory_value, choice.next_scene or 0)
+
+    assert len(out) == blob_offset, "record layout mismatch"
+    out += blob
+
+    Path(output_path).parent.mkdir(parents=True, exist_ok=True)
+    with open(output_path, "wb") as f:
+        f.write(out)
+
+    return len(scene_ids)
+
+
+def main():
+    output_path = sys.argv[1] if len(sys.argv) > 1 else "scenes.bin"
+    count = compile_archive(output_path)
+    print(f"Compiled {count} scenes into {output_path}")
+
+
+if __name__ == "__main__":
+    main()
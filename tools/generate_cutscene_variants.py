@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+"""
+Pre-generate downscaled variants of the cutscene art at build time.
+
+For each assets/cutscenes/*.jpg this writes <name>_<width>.jpg beside the
+copied original for every target width smaller than the source, so small
+screens decode a right-sized JPEG instead of downscaling 4K art at runtime.
+The frontend picks the variant closest to its viewport and falls back to
+the original when no variant exists.
+
+Requires Pillow. When Pillow is unavailable the script warns and exits
+successfully, leaving the build identical to one without variants.
+
+Usage: generate_cutscene_variants.py <source_dir> <output_dir>
+"""
+
+import os
+import sys
+
+# Keep in sync with kVariantWidths in src/cutscene_widget.cpp
+VARIANT_WIDTHS = [640, 1280, 1920]
+
+
+def main() -> int:
+    if len(sys.argv) != 3:
+        print(__doc__)
+        return 1
+
+    source_dir, output_dir = sys.argv[1], sys.argv[2]
+
+    try:
+        from PIL import Image
+    except ImportError:
+        print("generate_cutscene_variants: Pillow not installed, "
+              "skipping variant generation", file=sys.stderr)
+        return 0
+
+    os.makedirs(output_dir, exist_ok=True)
+
+    generated = 0
+    for name in sorted(os.listdir(source_dir)):
+        if not name.endswith(".jpg"):
+            continue
+        source_path = os.path.join(source_dir, name)
+        base, ext = os.path.splitext(name)
+
+        with Image.open(source_path) as image:
+            for width in VARIANT_WIDTHS:
+                if image.width <= width:
+                    continue
+                variant_path = os.path.join(output_dir, f"{base}_{width}{ext}")
+                if (os.path.exists(variant_path)
+                        and os.path.getmtime(variant_path) >= os.path.getmtime(source_path)):
+                    continue
+                height = round(image.height * width / image.width)
+                image.resize((width, height), Image.LANCZOS).save(
+                    variant_path, quality=85)
+                generated += 1
+
+    print(f"generate_cutscene_variants: {generated} variant(s) generated")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+Into the Dark - Scene-Schema Bindings Generator
+Emits typed C++ parsers for the engine protocol payloads from the same
+story definition the Python engine serves.
+
+The field tables below are the contract between python_backend/
+story_engine.py and the frontend structs in src/scene_data.h. At build
+time the generator instantiates the engine, builds real scene and memory
+payloads, and verifies every payload field against the tables — a field
+added, removed or retyped on either side fails the build here instead of
+silently parsing to defaults at runtime.
+
+The generated parsers make a single pass over each QJsonObject: every
+known key is presence- and type-checked once and stored with a direct
+member write, and a missing or mistyped field fails the whole parse.
+
+Usage: generate_scene_bindings.py <output_header>
+"""
+
+import hashlib
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "python_backend"))
+
+from story_engine import StoryEngine, _memory_payload, _scene_payload
+
+# (payload key, JSON type, C++ store expression or None, required)
+# Unbound fields are carried by the protocol but not consumed by the
+# frontend; optional fields are absent from persisted snapshots.
+SCENE_FIELDS = [
+    ("scene_id", "int", "out.sceneId = it.value().toInt()", True),
+    ("background", "str", "out.background = it.value().toString()", True),
+    ("dialogue", "str", "out.dialogue = it.value().toString()", True),
+    ("audio_track", "str", "out.audioTrack = it.value().toString()", True),
+    ("choices", "list", None, True),
+]
+
+CHOICE_FIELDS = [
+    ("text", "str", "out.text = it.value().toString()", True),
+    ("memory_type", "str", "out.memoryType = it.value().toString()", True),
+    ("memory_value", "int", None, False),
+    ("next_scene", "int", "out.nextScene = it.value().toInt()", True),
+]
+
+MEMORY_FIELDS = [
+    ("kindness", "float", "out.kindness = it.value().toDouble()", True),
+    ("obsession", "float", "out.obsession = it.value().toDouble()", True),
+    ("truth", "float", "out.truth = it.value().toDouble()", True),
+    ("trust", "float", "out.trust = it.value().toDouble()", True),
+    ("alignment", "str", "out.alignment = it.value().toString()", True),
+]
+
+PYTHON_TYPES = {"int": int, "str": str, "float": (int, float), "list": list}
+JSON_CHECKS = {"int": "isDouble", "str": "isString", "float": "isDouble",
+               "list": "isArray"}
+
+
+def check_payload(name, payload, fields):
+    """Fail loudly when the live payload and the field table disagree"""
+    table = {key: typ for key, typ, _, _ in fields}
+    for key, value in payload.items():
+        if key not in table:
+            sys.exit(f"schema drift: {name} payload field '{key}' "
+                     f"is not in the bindings table")
+        if not isinstance(value, PYTHON_TYPES[table[key]]):
+            sys.exit(f"schema drift: {name} field '{key}' is "
+                     f"{type(value).__name__}, bindings expect {table[key]}")
+    for key, _, _, required in fields:
+        if required and key not in payload:
+            sys.exit(f"schema drift: {name} payload is missing "
+                     f"required field '{key}'")
+
+
+def emit_parser(lines, function, struct, fields, extra=None):
+    required = sum(1 for _, _, _, req in fields if req)
+    lines.append(f"inline bool {function}(const QJsonObject &object, "
+                 f"{struct} &out)")
+    lines.append("{")
+    lines.append("    int matched = 0;")
+    lines.append("    for (auto it = object.constBegin(); "
+                 "it != object.constEnd(); ++it) {")
+    branch = "if"
+    for key, typ, store, required_field in fields:
+        lines.append(f"        {branch} (it.key() == "
+                     f"QLatin1String(\"{key}\")) {{")
+        lines.append(f"            if (!it.value().{JSON_CHECKS[typ]}())")
+        lines.append("                return false;")
+        if extra and key in extra:
+            lines.extend("            " + row for row in extra[key])
+        elif store:
+            lines.append(f"            {store};")
+        if required_field:
+            lines.append("            ++matched;")
+        lines.append("        }")
+        branch = "else if"
+    lines.append("    }")
+    lines.append("    // Envelope keys (id, shm regions, ...) pass through;")
+    lines.append("    // a missing or misspelled schema field fails the parse")
+    lines.append(f"    return matched == {required};")
+    lines.append("}")
+    lines.append("")
+
+
+def generate():
+    fingerprint = hashlib.sha1(
+        repr((SCENE_FIELDS, CHOICE_FIELDS, MEMORY_FIELDS)).encode()
+    ).hexdigest()[:12]
+
+    lines = [
+        "// Generated by tools/generate_scene_bindings.py — do not edit.",
+        "// Single-pass, schema-validated parsers for the engine protocol;",
+        "// regenerated whenever the story definition changes.",
+        "#ifndef SCENE_BINDINGS_H",
+        "#define SCENE_BINDINGS_H",
+        "",
+        "#include <QJsonArray>",
+        "#include <QJsonObject>",
+        "",
+        "#include \"scene_data.h\"",
+        "",
+        "namespace SceneBindings {",
+        "",
+        f"const char kSchemaFingerprint[] = \"{fingerprint}\";",
+        "",
+    ]
+
+    emit_parser(lines, "parseChoice", "ChoiceData", CHOICE_FIELDS)
+    emit_parser(lines, "parseScene", "SceneData", SCENE_FIELDS, extra={
+        "choices": [
+            "const QJsonArray choices = it.value().toArray();",
+            "out.choices.reserve(choices.size());",
+            "for (const QJsonValue &value : choices) {",
+            "    ChoiceData choice;",
+            "    if (!value.isObject() || !parseChoice(value.toObject(), choice))",
+            "        return false;",
+            "    out.choices.append(std::move(choice));",
+            "}",
+        ],
+    })
+    emit_parser(lines, "parseMemory", "MemoryData", MEMORY_FIELDS)
+
+    lines.append("} // namespace SceneBindings")
+    lines.append("")
+    lines.append("#endif // SCENE_BINDINGS_H")
+    return "\n".join(lines)
+
+
+def main() -> int:
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 1
+
+    # Validate the tables against payloads the engine actually serves
+    engine = StoryEngine()
+    scene_payload = _scene_payload(engine)
+    check_payload("scene", scene_payload, SCENE_FIELDS)
+    for choice in scene_payload["choices"]:
+        check_payload("choice", choice, CHOICE_FIELDS)
+    check_payload("memory", _memory_payload(engine), MEMORY_FIELDS)
+
+    output_path = Path(sys.argv[1])
+    output_path.parent.mkdir(parents=True, exist_ok=True)
+    output_path.write_text(generate() + "\n")
+    print(f"generate_scene_bindings: wrote {output_path}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())